@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "ns3/burst-fec-codec.h"
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+
+/**
+ * Microbenchmark of the FEC kernels used by BurstyApplication and BurstSink.
+ *
+ * Bursts of data shards are encoded with the XOR and Reed-Solomon schemes,
+ * and decoded after erasing as many random shards as the code can recover.
+ * The encoding and decoding throughput is reported in MB/s of burst data.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BurstFecBenchmark");
+
+/**
+ * Run the benchmark for a given code
+ * @param scheme the FEC scheme
+ * @param nBursts the number of bursts to encode and decode
+ * @param dataShards the number of data shards per burst
+ * @param parityShards the number of parity shards per burst
+ * @param shardSize the size of each shard [B]
+ * @param rng the random generator used for the data and the erasures
+ */
+void
+RunBenchmark(BurstFecCodec::Scheme scheme,
+             uint32_t nBursts,
+             uint32_t dataShards,
+             uint32_t parityShards,
+             uint32_t shardSize,
+             std::mt19937& rng)
+{
+    BurstFecCodec codec;
+    codec.Configure(scheme, dataShards, parityShards);
+
+    std::vector<uint8_t> data(size_t(dataShards) * shardSize);
+    std::vector<uint8_t> parity(size_t(parityShards) * shardSize);
+    std::generate(data.begin(), data.end(), [&rng]() { return uint8_t(rng()); });
+    std::vector<uint8_t> original = data;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nBursts; i++)
+    {
+        codec.Encode(data.data(), parity.data(), shardSize);
+    }
+    std::chrono::duration<double> encodeTime = std::chrono::steady_clock::now() - start;
+
+    // erase one data shard per parity shard, within the recovery capability of each group
+    std::vector<bool> received(dataShards + parityShards, true);
+    std::vector<uint32_t> erasable(dataShards);
+    std::iota(erasable.begin(), erasable.end(), 0);
+    std::shuffle(erasable.begin(), erasable.end(), rng);
+    std::vector<uint32_t> erasures(codec.GetGroups(), 0);
+    for (uint32_t shard : erasable)
+    {
+        uint32_t group = codec.GetGroup(shard);
+        if (erasures[group] < (parityShards + codec.GetGroups() - 1 - group) / codec.GetGroups())
+        {
+            received[shard] = false;
+            erasures[group]++;
+        }
+    }
+
+    std::chrono::duration<double> decodeTime(0);
+    for (uint32_t i = 0; i < nBursts; i++)
+    {
+        for (uint32_t j = 0; j < dataShards; j++)
+        {
+            if (!received[j])
+            {
+                std::fill_n(data.begin() + size_t(j) * shardSize, shardSize, 0);
+            }
+        }
+        start = std::chrono::steady_clock::now();
+        bool decoded = codec.Decode(data.data(), parity.data(), received, shardSize);
+        decodeTime += std::chrono::steady_clock::now() - start;
+        NS_ABORT_UNLESS(decoded && data == original);
+    }
+
+    double totMegabytes = double(nBursts) * data.size() / 1e6;
+    std::cout << (scheme == BurstFecCodec::Xor ? "XOR" : "Reed-Solomon") << " (" << dataShards
+              << "+" << parityShards << ", " << codec.GetGroups() << " groups): encode "
+              << totMegabytes / encodeTime.count() << " MB/s, decode "
+              << totMegabytes / decodeTime.count() << " MB/s with "
+              << std::count(received.begin(), received.end(), false) << " erasures" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nBursts = 1000;
+    uint32_t dataShards = 90;
+    uint32_t parityShards = 9;
+    uint32_t shardSize = 1173;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nBursts", "The number of bursts to encode and decode.", nBursts);
+    cmd.AddValue("dataShards", "The number of data fragments per burst.", dataShards);
+    cmd.AddValue("parityShards", "The number of parity fragments per burst.", parityShards);
+    cmd.AddValue("shardSize", "The payload of each fragment [B].", shardSize);
+    cmd.AddValue("seed", "The seed used to generate data and erasures.", seed);
+    cmd.Parse(argc, argv);
+
+    std::mt19937 rng(seed);
+    RunBenchmark(BurstFecCodec::Xor,
+                 nBursts,
+                 dataShards,
+                 std::min(parityShards, dataShards),
+                 shardSize,
+                 rng);
+    RunBenchmark(BurstFecCodec::ReedSolomon, nBursts, dataShards, parityShards, shardSize, rng);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "ns3/burst-reassembly-buffer.h"
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <numeric>
+#include <random>
+
+/**
+ * Microbenchmark of the fragment reassembly performed by BurstSink.
+ *
+ * Bursts of fragments are fed to a BurstReassemblyBuffer, either in order or
+ * shuffled, and the reassembly throughput is reported in fragments/s.
+ * For comparison, the same fragments are also reassembled with an ordered
+ * map of out-of-order fragments and an incrementally grown burst buffer,
+ * i.e., the approach previously used by BurstSink.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BurstReassemblyBenchmark");
+
+/**
+ * Reassemble a burst with an ordered map of out-of-order fragments
+ * @param fragments the fragments of the burst, in arrival order
+ * @param order the fragment sequence numbers, in arrival order
+ * @return the reassembled burst
+ */
+Ptr<Packet>
+MapReassembly(const std::vector<Ptr<Packet>>& fragments, const std::vector<uint32_t>& order)
+{
+    std::map<uint32_t, Ptr<Packet>> unorderedFragments;
+    Ptr<Packet> burstBuffer = Create<Packet>(0);
+    uint32_t fragmentsMerged = 0;
+    for (uint32_t fragSeq : order)
+    {
+        if (fragSeq != fragmentsMerged)
+        {
+            unorderedFragments.insert(std::make_pair(fragSeq, fragments[fragSeq]));
+            continue;
+        }
+        burstBuffer->AddAtEnd(fragments[fragSeq]);
+        fragmentsMerged++;
+        auto it = unorderedFragments.begin();
+        while (it != unorderedFragments.end() && it->first == fragmentsMerged)
+        {
+            burstBuffer->AddAtEnd(it->second);
+            fragmentsMerged++;
+            it = unorderedFragments.erase(it);
+        }
+    }
+    return burstBuffer;
+}
+
+/**
+ * Reassemble a burst with a BurstReassemblyBuffer
+ * @param buffer the buffer, reused across bursts
+ * @param seq the sequence number of the burst
+ * @param burstSize the size of the burst [B]
+ * @param fragments the fragments of the burst
+ * @param order the fragment sequence numbers, in arrival order
+ * @return the reassembled burst
+ */
+Ptr<Packet>
+SlotReassembly(BurstReassemblyBuffer& buffer,
+               uint64_t seq,
+               uint64_t burstSize,
+               const std::vector<Ptr<Packet>>& fragments,
+               const std::vector<uint32_t>& order)
+{
+    buffer.Reset(seq, fragments.size(), burstSize);
+    for (uint32_t fragSeq : order)
+    {
+        buffer.AddFragment(fragSeq, fragments[fragSeq]);
+    }
+    return buffer.AssembleBurst();
+}
+
+/**
+ * Run the benchmark for a given arrival order
+ * @param name the name of the arrival order
+ * @param nBursts the number of bursts to reassemble
+ * @param fragments the fragments of the burst
+ * @param order the fragment sequence numbers, in arrival order
+ */
+void
+RunBenchmark(std::string name,
+             uint32_t nBursts,
+             const std::vector<Ptr<Packet>>& fragments,
+             const std::vector<uint32_t>& order)
+{
+    uint64_t burstSize = 0;
+    for (const auto& fragment : fragments)
+    {
+        burstSize += fragment->GetSize();
+    }
+    double totFragments = double(nBursts) * fragments.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nBursts; i++)
+    {
+        Ptr<Packet> burst = MapReassembly(fragments, order);
+        NS_ABORT_UNLESS(burst->GetSize() == burstSize);
+    }
+    std::chrono::duration<double> mapTime = std::chrono::steady_clock::now() - start;
+
+    BurstReassemblyBuffer buffer;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nBursts; i++)
+    {
+        Ptr<Packet> burst = SlotReassembly(buffer, i, burstSize, fragments, order);
+        NS_ABORT_UNLESS(burst->GetSize() == burstSize);
+    }
+    std::chrono::duration<double> slotTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << " arrival: map " << totFragments / mapTime.count()
+              << " fragments/s, bitmap-and-slot " << totFragments / slotTime.count()
+              << " fragments/s (speed-up " << mapTime.count() / slotTime.count() << "x)"
+              << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nBursts = 10000;
+    uint32_t nFragments = 90;
+    uint32_t fragmentPayload = 1176;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nBursts", "The number of bursts to reassemble.", nBursts);
+    cmd.AddValue("nFragments", "The number of fragments per burst.", nFragments);
+    cmd.AddValue("fragmentPayload", "The payload of each fragment [B].", fragmentPayload);
+    cmd.AddValue("seed", "The seed used to shuffle the fragments.", seed);
+    cmd.Parse(argc, argv);
+
+    std::vector<Ptr<Packet>> fragments;
+    for (uint32_t i = 0; i < nFragments; i++)
+    {
+        fragments.push_back(Create<Packet>(fragmentPayload));
+    }
+
+    std::vector<uint32_t> order(nFragments);
+    std::iota(order.begin(), order.end(), 0);
+    RunBenchmark("In-order", nBursts, fragments, order);
+
+    std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+    RunBenchmark("Shuffled", nBursts, fragments, order);
+
+    return 0;
+}
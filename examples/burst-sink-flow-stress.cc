@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/burst-flow-key.h"
+#include "ns3/burst-sink-helper.h"
+#include "ns3/bursty-helper.h"
+#include "ns3/core-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Stress test of the flow demultiplexing performed by BurstSink.
+ *
+ * A sink node receives bursts from nFlows concurrent flows, originated by
+ * flowsPerHost BurstyApplications on each source host, half of the hosts
+ * using IPv4 and half IPv6. All hosts share a fast CSMA channel with the sink
+ * node, where a BurstSink per address family demultiplexes the fragments of
+ * all its flows. The start of the flows is spread over a period, so that
+ * fragments of different flows are interleaved at the sinks.
+ *
+ * The number of flows and the memory of the flow table of each sink are
+ * reported. Since the flows of the same host only differ by port, a flow
+ * table keyed by IP address alone would merge them, and the received bursts
+ * would not match the sent ones.
+ *
+ * The wall-clock time of the whole simulation is dominated by the channel
+ * and the IP stack, as every frame is delivered to every node of the CSMA
+ * channel. The lookup cost is thus measured on its own: the source of each
+ * received fragment is recorded, in arrival order, and the recorded sources
+ * are then looked up lookupRounds times in a flow table holding all flows,
+ * building the FlowKey of each source and finding it, as BurstSink does for
+ * each fragment. The wall-clock time per lookup is reported.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BurstSinkFlowStress");
+
+/**
+ * Record the source of a received fragment
+ * @param sources the sources of the received fragments, in arrival order
+ * @param fragment the fragment received
+ * @param from the source address of the fragment
+ * @param to the address the fragment was received on
+ * @param header the header of the fragment
+ */
+void
+RecordSource(std::vector<Address>* sources,
+             Ptr<const Packet> fragment,
+             const Address& from,
+             const Address& to,
+             const SeqTsSizeFragHeader& header)
+{
+    sources->push_back(from);
+}
+
+/**
+ * Look the recorded sources up in a flow table holding all the flows
+ * @param sources the sources of the received fragments, in arrival order
+ * @param rounds the number of times the sources are looked up
+ * @return the wall-clock time per lookup [ns]
+ */
+double
+RunLookupBenchmark(const std::vector<Address>& sources, uint32_t rounds)
+{
+    std::unordered_map<FlowKey, uint64_t, FlowKeyHash> flowTable;
+    for (const auto& from : sources)
+    {
+        flowTable.emplace(FlowKey(from), 0);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        for (const auto& from : sources)
+        {
+            auto it = flowTable.find(FlowKey(from));
+            NS_ABORT_UNLESS(it != flowTable.end());
+            it->second++;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double lookups = double(rounds) * sources.size();
+    return lookups > 0 ? elapsed.count() * 1e9 / lookups : 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+    double simTimeSec = 1;
+    uint32_t nFlows = 1000;
+    uint32_t flowsPerHost = 10;
+    uint32_t fragmentSize = 1200;
+    uint32_t burstFragments = 5;
+    double periodMs = 10;
+    uint32_t lookupRounds = 100;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("SimulationTime", "Length of simulation in seconds.", simTimeSec);
+    cmd.AddValue("nFlows", "The number of concurrent flows.", nFlows);
+    cmd.AddValue("flowsPerHost", "The number of flows originated by each host.", flowsPerHost);
+    cmd.AddValue("fragmentSize", "The size of the fragments [B].", fragmentSize);
+    cmd.AddValue("burstFragments", "The number of fragments of each burst.", burstFragments);
+    cmd.AddValue("periodMs", "The period between consecutive bursts of a flow [ms].", periodMs);
+    cmd.AddValue("lookupRounds",
+                 "The number of times the recorded sources are looked up.",
+                 lookupRounds);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(flowsPerHost == 0, "At least one flow per host is needed");
+
+    Time::SetResolution(Time::NS);
+    // Addresses are usable right away, without waiting for the duplicate address detection
+    Config::SetDefault("ns3::Icmpv6L4Protocol::DAD", BooleanValue(false));
+
+    // Setup the sink node and the source hosts on a channel fast enough not to queue fragments
+    uint32_t nHosts = (nFlows + flowsPerHost - 1) / flowsPerHost;
+    NodeContainer sinkNode;
+    sinkNode.Create(1);
+    NodeContainer hosts;
+    hosts.Create(nHosts);
+    NodeContainer allNodes(sinkNode, hosts);
+
+    CsmaHelper csma;
+    csma.SetChannelAttribute("DataRate", StringValue("100Gbps"));
+    csma.SetChannelAttribute("Delay", StringValue("1us"));
+    NetDeviceContainer devices = csma.Install(allNodes);
+
+    InternetStackHelper stack;
+    stack.Install(allNodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.0.0", "255.255.0.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    Ipv6AddressHelper address6;
+    address6.SetBase(Ipv6Address("2001:1::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer interfaces6 = address6.Assign(devices);
+
+    uint16_t portNumber = 50000;
+    uint64_t burstSize = uint64_t(fragmentSize) * burstFragments;
+    Ptr<UniformRandomVariable> startRv = CreateObject<UniformRandomVariable>();
+
+    // Install flowsPerHost bursty applications on each host, sending to the sink of its family
+    ApplicationContainer serverApps;
+    for (uint32_t flow = 0; flow < nFlows; flow++)
+    {
+        uint32_t host = flow / flowsPerHost;
+        Address sinkAddress = (host % 2 == 0)
+                                  ? Address(InetSocketAddress(interfaces.GetAddress(0), portNumber))
+                                  : Address(Inet6SocketAddress(interfaces6.GetAddress(0, 1),
+                                                               portNumber));
+
+        BurstyHelper burstyHelper("ns3::UdpSocketFactory", sinkAddress);
+        burstyHelper.SetAttribute("FragmentSize", UintegerValue(fragmentSize));
+        burstyHelper.SetBurstGenerator(
+            "ns3::SimpleBurstGenerator",
+            "PeriodRv",
+            StringValue("ns3::ConstantRandomVariable[Constant=" + std::to_string(periodMs / 1e3) +
+                        "]"),
+            "BurstSizeRv",
+            StringValue("ns3::ConstantRandomVariable[Constant=" + std::to_string(burstSize) +
+                        "]"));
+
+        ApplicationContainer app = burstyHelper.Install(hosts.Get(host));
+        app.Start(MilliSeconds(startRv->GetValue(0, periodMs)));
+        serverApps.Add(app);
+    }
+    serverApps.Stop(Seconds(simTimeSec));
+
+    // Create a burst sink per address family on the sink node
+    BurstSinkHelper burstSinkHelper("ns3::UdpSocketFactory",
+                                    InetSocketAddress(Ipv4Address::GetAny(), portNumber));
+    ApplicationContainer sinkApps = burstSinkHelper.Install(sinkNode);
+    BurstSinkHelper burstSinkHelper6("ns3::UdpSocketFactory",
+                                     Inet6SocketAddress(Ipv6Address::GetAny(), portNumber));
+    sinkApps.Add(burstSinkHelper6.Install(sinkNode));
+
+    std::vector<Address> sources;
+    for (uint32_t i = 0; i < sinkApps.GetN(); i++)
+    {
+        sinkApps.Get(i)->TraceConnectWithoutContext("FragmentRx",
+                                                    MakeBoundCallback(&RecordSource, &sources));
+    }
+
+    Simulator::Run();
+
+    uint64_t txBursts = 0;
+    uint64_t txFragments = 0;
+    for (uint32_t i = 0; i < serverApps.GetN(); i++)
+    {
+        Ptr<BurstyApplication> burstyApp = serverApps.Get(i)->GetObject<BurstyApplication>();
+        txBursts += burstyApp->GetTotalTxBursts();
+        txFragments += burstyApp->GetTotalTxFragments();
+    }
+
+    uint64_t rxBursts = 0;
+    uint64_t rxFragments = 0;
+    for (uint32_t i = 0; i < sinkApps.GetN(); i++)
+    {
+        Ptr<BurstSink> burstSink = sinkApps.Get(i)->GetObject<BurstSink>();
+        rxBursts += burstSink->GetTotalRxBursts();
+        rxFragments += burstSink->GetTotalRxFragments();
+        std::cout << (i == 0 ? "IPv4" : "IPv6") << " sink: " << burstSink->GetActiveFlows()
+                  << " flows, flow table of " << burstSink->GetFlowTableMemory() << " B"
+                  << std::endl;
+    }
+
+    std::cout << "Flows: " << nFlows << ", hosts: " << nHosts << std::endl;
+    std::cout << "Total RX bursts: " << txBursts << "/" << rxBursts << std::endl;
+    std::cout << "Total RX fragments: " << txFragments << "/" << rxFragments << std::endl;
+    std::cout << "Flow lookup: " << RunLookupBenchmark(sources, lookupRounds)
+              << " ns per received fragment" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "ns3/burst-trace-store.h"
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <iostream>
+
+/**
+ * Converts a CSV burst trace into the binary trace format.
+ *
+ * The CSV trace is parsed as done by TraceFileBurstGenerator, together with
+ * the metadata found in its comment header, and written as a binary trace
+ * (see BurstTraceFileHeader), which TraceFileBurstGenerator memory-maps
+ * instead of parsing. The binary trace is then read back, checking that it
+ * holds the same bursts, and the time taken to load either format is
+ * reported.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("BurstTraceConverter");
+
+/**
+ * Load a trace and measure the time taken
+ * @param path the path of the trace file
+ * @param trace the loaded trace
+ * @return the time taken to load the trace [s]
+ */
+double
+LoadTrace(const std::string& path, Ptr<const BurstTrace>& trace)
+{
+    auto start = std::chrono::steady_clock::now();
+    trace = BurstTraceStore::Get(path);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string input = "";  // the CSV trace to convert
+    std::string output = ""; // the binary trace to write, by default input with extension .bin
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "the CSV trace to convert", input);
+    cmd.AddValue("output",
+                 "the binary trace to write; by default, the input with extension .bin",
+                 output);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty(), "An input trace is required");
+    if (output.empty())
+    {
+        output = input.substr(0, input.rfind('.')) + ".bin";
+    }
+
+    Ptr<const BurstTrace> csvTrace;
+    double csvLoadTime = LoadTrace(input, csvTrace);
+    NS_ABORT_MSG_IF(csvTrace->IsMapped(), input << " is already a binary trace");
+    csvTrace->Save(output);
+
+    Ptr<const BurstTrace> binTrace;
+    double binLoadTime = LoadTrace(output, binTrace);
+    NS_ABORT_MSG_IF(binTrace->GetNBursts() != csvTrace->GetNBursts(),
+                    "The binary trace holds " << binTrace->GetNBursts() << " bursts instead of "
+                                              << csvTrace->GetNBursts());
+    for (uint64_t index = 0; index < csvTrace->GetNBursts(); index++)
+    {
+        NS_ABORT_MSG_IF(binTrace->GetBurstSize(index) != csvTrace->GetBurstSize(index) ||
+                            binTrace->GetPeriod(index) != csvTrace->GetPeriod(index) ||
+                            binTrace->GetImportance(index) != csvTrace->GetImportance(index),
+                        "Burst " << index << " differs in the binary trace");
+    }
+
+    std::cout << "Converted " << input << " into " << output << std::endl;
+    std::cout << "app=\"" << binTrace->GetAppName() << "\", fps=" << binTrace->GetFrameRate()
+              << ", rate=" << binTrace->GetDataRate()
+              << " Mbps, duration=" << binTrace->GetDuration().GetSeconds()
+              << " s, bursts=" << binTrace->GetNBursts() << std::endl;
+    std::cout << "loadTimeCsv=" << csvLoadTime << " s, loadTimeBinary=" << binLoadTime << " s"
+              << std::endl;
+
+    return 0;
+}
@@ -21,6 +21,10 @@
  * An example of how the BurstyApplication works.
  * Traces for RX/TX fragments/bursts are extracted as well as the setup of
  * a BurstyApplication with a SimpleBurstGenerator.
+ * With nSinks greater than one, the same bursts are fanned out to further
+ * BurstSinks, on consecutive ports of the same node, added as remotes of the
+ * BurstyApplication. If localPort is set, the socket towards the first sink
+ * binds to it, while the others bind to ephemeral ports.
  */
 
 using namespace ns3;
@@ -93,10 +97,16 @@ int
 main(int argc, char* argv[])
 {
     double simTimeSec = 10;
+    uint32_t nSinks = 1;
+    uint16_t localPort = 0;
     CommandLine cmd(__FILE__);
     cmd.AddValue("SimulationTime", "Length of simulation in seconds.", simTimeSec);
+    cmd.AddValue("nSinks", "The number of sinks receiving the same bursts.", nSinks);
+    cmd.AddValue("localPort", "The port of the bursty application, if non-zero.", localPort);
     cmd.Parse(argc, argv);
 
+    NS_ABORT_MSG_IF(nSinks == 0, "At least one sink is needed");
+
     Time::SetResolution(Time::NS);
     LogComponentEnableAll(LOG_PREFIX_TIME);
     LogComponentEnable("BurstyApplicationExample", LOG_INFO);
@@ -133,6 +143,15 @@ main(int argc, char* argv[])
                                    StringValue("ns3::ConstantRandomVariable[Constant=100e-3]"),
                                    "BurstSizeRv",
                                    StringValue("ns3::ConstantRandomVariable[Constant=10e3]"));
+    if (localPort > 0)
+    {
+        InetSocketAddress local(Ipv4Address::GetAny(), localPort);
+        burstyHelper.SetAttribute("Local", AddressValue(local));
+    }
+    for (uint32_t i = 1; i < nSinks; i++)
+    {
+        burstyHelper.AddRemote(InetSocketAddress(serverAddress, portNumber + i));
+    }
 
     // Install bursty application
     ApplicationContainer serverApps = burstyHelper.Install(nodes.Get(1));
@@ -142,30 +161,37 @@ main(int argc, char* argv[])
     burstyApp->TraceConnectWithoutContext("FragmentTx", MakeCallback(&FragmentTx));
     burstyApp->TraceConnectWithoutContext("BurstTx", MakeCallback(&BurstTx));
 
-    // Create burst sink helper
-    BurstSinkHelper burstSinkHelper("ns3::UdpSocketFactory",
-                                    InetSocketAddress(sinkAddress, portNumber));
-
-    // Install burst sink
-    ApplicationContainer clientApps = burstSinkHelper.Install(nodes.Get(0));
-    Ptr<BurstSink> burstSink = clientApps.Get(0)->GetObject<BurstSink>();
+    // Create burst sink helper and install a burst sink per remote
+    ApplicationContainer clientApps;
+    for (uint32_t i = 0; i < nSinks; i++)
+    {
+        BurstSinkHelper burstSinkHelper("ns3::UdpSocketFactory",
+                                        InetSocketAddress(sinkAddress, portNumber + i));
+        clientApps.Add(burstSinkHelper.Install(nodes.Get(0)));
+        Ptr<BurstSink> burstSink = clientApps.Get(i)->GetObject<BurstSink>();
 
-    // Example of connecting to the trace sources
-    burstSink->TraceConnectWithoutContext("BurstRx", MakeCallback(&BurstRx));
-    burstSink->TraceConnectWithoutContext("FragmentRx", MakeCallback(&FragmentRx));
+        // Example of connecting to the trace sources
+        burstSink->TraceConnectWithoutContext("BurstRx", MakeCallback(&BurstRx));
+        burstSink->TraceConnectWithoutContext("FragmentRx", MakeCallback(&FragmentRx));
+    }
 
     // Stop bursty app after simTimeSec
     serverApps.Stop(Seconds(simTimeSec));
     Simulator::Run();
     Simulator::Destroy();
 
-    // Stats
-    std::cout << "Total RX bursts: " << burstyApp->GetTotalTxBursts() << "/"
-              << burstSink->GetTotalRxBursts() << std::endl;
-    std::cout << "Total RX fragments: " << burstyApp->GetTotalTxFragments() << "/"
-              << burstSink->GetTotalRxFragments() << std::endl;
-    std::cout << "Total RX bytes: " << burstyApp->GetTotalTxBytes() << "/"
-              << burstSink->GetTotalRxBytes() << std::endl;
+    // Stats: fragments and bytes are counted by the application over all sinks
+    for (uint32_t i = 0; i < nSinks; i++)
+    {
+        Ptr<BurstSink> burstSink = clientApps.Get(i)->GetObject<BurstSink>();
+        std::cout << "Sink " << i << std::endl;
+        std::cout << "Total RX bursts: " << burstyApp->GetTotalTxBursts() << "/"
+                  << burstSink->GetTotalRxBursts() << std::endl;
+        std::cout << "Total RX fragments: " << burstyApp->GetTotalTxFragments() / nSinks << "/"
+                  << burstSink->GetTotalRxFragments() << std::endl;
+        std::cout << "Total RX bytes: " << burstyApp->GetTotalTxBytes() / nSinks << "/"
+                  << burstSink->GetTotalRxBytes() << std::endl;
+    }
 
     return 0;
 }
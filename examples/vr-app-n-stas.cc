@@ -9,6 +9,7 @@
  */
 
 #include "ns3/boolean.h"
+#include "ns3/burst-rate-controller.h"
 #include "ns3/burst-sink-helper.h"
 #include "ns3/bursty-helper.h"
 #include "ns3/command-line.h"
@@ -122,6 +123,18 @@ FragmentRx(Ptr<OutputStreamWrapper> traceFile,
                             << fragment->GetSize() << "\n";
 }
 
+void
+FrameDisplayed(Ptr<OutputStreamWrapper> traceFile,
+               const Address& from,
+               const SeqTsSizeFragHeader& header,
+               Time latency,
+               Time lateness)
+{
+    *traceFile->GetStream() << AddressToString(from) << "," << header.GetTs().GetNanoSeconds()
+                            << "," << Simulator::Now().GetNanoSeconds() << "," << header.GetSeq()
+                            << "," << lateness.GetNanoSeconds() << "\n";
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -131,8 +144,14 @@ main(int argc, char* argv[])
     double frameRate = 60;                 // the app frame rate [FPS]
     std::string vrAppName = "VirusPopper"; // the app name
     std::string burstGeneratorType =
-        "model";                // type of burst generator {"model", "trace", "deterministic"}
-    double simulationTime = 10; // simulation time in seconds
+        "model";                    // type of burst generator {"model", "trace", "deterministic"}
+    double simulationTime = 10;     // simulation time in seconds
+    bool adaptiveRate = false;      // adapt the app target data rate to the feedback of the AP
+    double targetDelay = 20;        // one-way delay target of the adaptive rate [ms]
+    uint32_t vrTos = 0;             // IPv4 TOS of the VR fragments, 0 to leave them untagged
+    std::string protocol = "Udp";   // transport protocol {"Udp", "Tcp"}
+    double playoutDelay = 0;        // target delay of the playout stage at the AP [ms], 0 disables
+    std::string traceMode = "Once"; // end of the trace {"Once", "Loop", "BlockBootstrap"}
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("nStas", "the number of STAs around the AP", nStas);
@@ -144,6 +163,25 @@ main(int argc, char* argv[])
                  "type of burst generator {\"model\", \"trace\", \"deterministic\"}",
                  burstGeneratorType);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("adaptiveRate",
+                 "adapt the app target data rate, up to appRate, to the feedback of the AP "
+                 "(model burst generator only)",
+                 adaptiveRate);
+    cmd.AddValue("targetDelay", "the one-way delay target of the adaptive rate [ms]", targetDelay);
+    cmd.AddValue("vrTos",
+                 "the IPv4 TOS of the VR fragments, e.g., 184 (DSCP EF) for the AC_VO access "
+                 "category; 0 leaves them untagged",
+                 vrTos);
+    cmd.AddValue("protocol", "the transport protocol {\"Udp\", \"Tcp\"}", protocol);
+    cmd.AddValue("playoutDelay",
+                 "the target delay of the playout stage at the AP, displaying the frames at "
+                 "frameRate [ms]; 0 disables it",
+                 playoutDelay);
+    cmd.AddValue("traceMode",
+                 "how the trace burst generator proceeds at the end of the trace "
+                 "{\"Once\", \"Loop\", \"BlockBootstrap\"}; the latter two allow simulations "
+                 "longer than the trace",
+                 traceMode);
     cmd.Parse(argc, argv);
 
     uint32_t fragmentSize = 1472; // bytes
@@ -237,13 +275,25 @@ main(int argc, char* argv[])
 
     // Setting applications
     uint16_t port = 50000;
-    BurstSinkHelper server("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), port));
+    NS_ABORT_MSG_IF(protocol != "Udp" && protocol != "Tcp", "Unknown protocol " << protocol);
+    std::string socketFactory = "ns3::" + protocol + "SocketFactory";
+    BurstSinkHelper server(socketFactory, InetSocketAddress(Ipv4Address::GetAny(), port));
+    if (adaptiveRate)
+    {
+        NS_ABORT_MSG_IF(burstGeneratorType != "model",
+                        "adaptiveRate requires the model burst generator");
+        server.SetAttribute("FeedbackInterval", TimeValue(MilliSeconds(100)));
+    }
+    if (playoutDelay > 0)
+    {
+        server.SetAttribute("PlayoutDelay", TimeValue(MilliSeconds(playoutDelay)));
+        server.SetAttribute("PlayoutFrameRate", DoubleValue(frameRate));
+    }
     ApplicationContainer serverApp = server.Install(wifiApNode);
     serverApp.Start(Seconds(0.0));
     serverApp.Stop(Seconds(simulationTime + 1));
 
-    BurstyHelper client("ns3::UdpSocketFactory",
-                        InetSocketAddress(ApInterface.GetAddress(0), port));
+    BurstyHelper client(socketFactory, InetSocketAddress(ApInterface.GetAddress(0), port));
     client.SetAttribute("FragmentSize", UintegerValue(fragmentSize));
 
     if (burstGeneratorType == "model")
@@ -292,7 +342,9 @@ main(int argc, char* argv[])
 
         client.SetBurstGenerator("ns3::TraceFileBurstGenerator",
                                  "TraceFile",
-                                 StringValue(filenameSs.str()));
+                                 StringValue(filenameSs.str()),
+                                 "TraceMode",
+                                 StringValue(traceMode));
     }
     else if (burstGeneratorType == "deterministic")
     {
@@ -333,16 +385,39 @@ main(int argc, char* argv[])
         Ptr<BurstyApplication> app = DynamicCast<BurstyApplication>(clientApps.Get(i));
         app->SetStartTime(startTime);
 
+        if (vrTos > 0)
+        {
+            // all bursts of these generators have importance class 0
+            app->SetImportanceTos(0, vrTos);
+        }
+
+        if (adaptiveRate)
+        {
+            // each app adapts its rate independently
+            Ptr<BurstRateController> controller = CreateObjectWithAttributes<BurstRateController>(
+                "MaxDataRate",
+                DataRateValue(DataRate(appRate)),
+                "TargetDelay",
+                TimeValue(MilliSeconds(targetDelay)));
+            app->SetAttribute("RateController", PointerValue(controller));
+        }
+
         // decouple trace file burst generators
         PointerValue val;
         app->GetAttribute("BurstGenerator", val);
         Ptr<TraceFileBurstGenerator> tfbg = DynamicCast<TraceFileBurstGenerator>(val.GetObject());
         if (tfbg)
         {
-            NS_ABORT_MSG_IF(tfbg->GetTraceDuration() < simulationTime,
-                            "Trace too short for this simulation");
-
-            double traceStartTime = y->GetValue(0, tfbg->GetTraceDuration() - simulationTime);
+            // looped or bootstrapped traces can start anywhere
+            double maxTraceStartTime = tfbg->GetTraceDuration();
+            if (traceMode == "Once")
+            {
+                NS_ABORT_MSG_IF(tfbg->GetTraceDuration() < simulationTime,
+                                "Trace too short for this simulation: try traceMode=Loop");
+                maxTraceStartTime -= simulationTime;
+            }
+
+            double traceStartTime = y->GetValue(0, maxTraceStartTime);
             NS_LOG_UNCOND("STA" << i << " will start its trace from " << traceStartTime);
             tfbg->SetAttribute("StartTime", DoubleValue(traceStartTime));
         }
@@ -361,6 +436,15 @@ main(int argc, char* argv[])
         ->TraceConnectWithoutContext("BurstRx", MakeBoundCallback(&BurstRx, burstTrace));
     DynamicCast<BurstSink>(serverApp.Get(0))
         ->TraceConnectWithoutContext("FragmentRx", MakeBoundCallback(&FragmentRx, fragmentTrace));
+    if (playoutDelay > 0)
+    {
+        Ptr<OutputStreamWrapper> playoutTrace = ascii.CreateFileStream("playoutTrace.csv");
+        *playoutTrace->GetStream() << "SrcAddress,TxTime_ns,DisplayTime_ns,BurstSeq,Lateness_ns"
+                                   << std::endl;
+        DynamicCast<BurstSink>(serverApp.Get(0))
+            ->TraceConnectWithoutContext("FrameDisplayed",
+                                         MakeBoundCallback(&FrameDisplayed, playoutTrace));
+    }
 
     // Start simulation
     Simulator::Stop(Seconds(simulationTime + 1));
@@ -405,6 +489,28 @@ main(int argc, char* argv[])
               << double(fragmentsReceived) / totFragmentSent * 100 << "%)" << std::endl;
     *rxFragments->GetStream() << fragmentsReceived << std::endl;
 
+    if (playoutDelay > 0)
+    {
+        Ptr<BurstSink> sink = DynamicCast<BurstSink>(serverApp.Get(0));
+        std::cout << "framesDisplayed=" << sink->GetTotalDisplayedFrames()
+                  << ", framesLate=" << sink->GetTotalLateFrames()
+                  << ", framesSkipped=" << sink->GetTotalSkippedFrames()
+                  << ", playoutStalls=" << sink->GetTotalPlayoutStalls() << std::endl;
+    }
+
+    if (adaptiveRate)
+    {
+        for (uint32_t i = 0; i < nStas; i++)
+        {
+            DataRateValue targetDataRate;
+            DynamicCast<BurstyApplication>(clientApps.Get(i))
+                ->GetBurstGenerator()
+                ->GetAttribute("TargetDataRate", targetDataRate);
+            std::cout << "finalTargetDataRate(" << i << ")=" << targetDataRate.Get() << ", ";
+        }
+        std::cout << std::endl;
+    }
+
     Simulator::Destroy();
 
     return 0;
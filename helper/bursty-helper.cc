@@ -9,6 +9,7 @@
  */
 #include "bursty-helper.h"
 
+#include "ns3/burst-generator.h"
 #include "ns3/bursty-application.h"
 #include "ns3/data-rate.h"
 #include "ns3/inet-socket-address.h"
@@ -16,10 +17,8 @@
 #include "ns3/packet-socket-address.h"
 #include "ns3/pointer.h"
 #include "ns3/random-variable-stream.h"
-#include "ns3/simple-burst-generator.h"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
-#include "ns3/vr-burst-generator.h"
 
 namespace ns3
 {
@@ -37,6 +36,12 @@ BurstyHelper::SetAttribute(std::string name, const AttributeValue& value)
     m_burstyApplicationFactory.Set(name, value);
 }
 
+void
+BurstyHelper::AddRemote(Address address)
+{
+    m_extraRemotes.push_back(address);
+}
+
 void
 BurstyHelper::SetBurstGenerator(std::string type,
                                 std::string n1,
@@ -93,6 +98,10 @@ BurstyHelper::InstallPriv(Ptr<Node> node) const
     Ptr<BurstGenerator> generator = m_burstGeneratorFactory.Create<BurstGenerator>();
 
     app->SetAttribute("BurstGenerator", PointerValue(generator));
+    for (const auto& remote : m_extraRemotes)
+    {
+        app->AddRemote(remote);
+    }
     node->AddApplication(app);
 
     return app;
@@ -109,20 +118,9 @@ BurstyHelper::AssignStreams(NodeContainer c, int64_t stream)
         for (uint32_t j = 0; j < node->GetNApplications(); j++)
         {
             Ptr<BurstyApplication> app = DynamicCast<BurstyApplication>(node->GetApplication(j));
-            if (app)
+            if (app && app->GetBurstGenerator())
             {
-                Ptr<SimpleBurstGenerator> simpleGenerator =
-                    DynamicCast<SimpleBurstGenerator>(app->GetBurstGenerator()); // TODO improve
-                if (simpleGenerator)
-                {
-                    currentStream += simpleGenerator->AssignStreams(currentStream);
-                }
-                Ptr<VrBurstGenerator> vrGenerator =
-                    DynamicCast<VrBurstGenerator>(app->GetBurstGenerator()); // TODO improve
-                if (vrGenerator)
-                {
-                    currentStream += vrGenerator->AssignStreams(currentStream);
-                }
+                currentStream += app->GetBurstGenerator()->AssignStreams(currentStream);
             }
         }
     }
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace ns3
 {
@@ -54,6 +55,14 @@ class BurstyHelper
      */
     void SetAttribute(std::string name, const AttributeValue& value);
 
+    /**
+     * Add a further destination to each BurstyApplication created through
+     * BurstyHelper::Install, which fans out the same bursts to all of them.
+     *
+     * @param address the address of the further remote node to send traffic to
+     */
+    void AddRemote(Address address);
+
     /**
      * Each BurstyApplication must have a BurstGenerator.
      * This method allows one to set the type of the BurstGenerator that is automatically
@@ -123,7 +132,8 @@ class BurstyHelper
      * Assign a fixed random variable stream number to the random variables
      * used by this model.  Return the number of streams (possibly zero) that
      * have been assigned.  The Install() method should have previously been
-     * called by the user.
+     * called by the user.  Streams are assigned by the BurstGenerator of each
+     * BurstyApplication, whatever its type.
      *
      * @param stream first stream index to use
      * @param c NodeContainer of the set of nodes for which the BurstyApplication
@@ -144,6 +154,7 @@ class BurstyHelper
 
     ObjectFactory m_burstyApplicationFactory; //!< BurstyApplication factory
     ObjectFactory m_burstGeneratorFactory;    //!< BurstGenerator factory
+    std::vector<Address> m_extraRemotes;      //!< Further destinations of the applications
 };
 
 } // namespace ns3
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-control-header.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstControlHeader");
+
+NS_OBJECT_ENSURE_REGISTERED(BurstControlHeader);
+
+BurstControlHeader::BurstControlHeader(Type type)
+    : m_type(type)
+{
+    NS_LOG_FUNCTION(this << type);
+}
+
+TypeId
+BurstControlHeader::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::BurstControlHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<BurstControlHeader>();
+    return tid;
+}
+
+TypeId
+BurstControlHeader::GetInstanceTypeId(void) const
+{
+    return GetTypeId();
+}
+
+void
+BurstControlHeader::SetType(Type type)
+{
+    m_type = type;
+}
+
+BurstControlHeader::Type
+BurstControlHeader::GetType(void) const
+{
+    return m_type;
+}
+
+void
+BurstControlHeader::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    os << "(type=" << uint16_t(m_type) << ")";
+}
+
+uint32_t
+BurstControlHeader::GetSerializedSize(void) const
+{
+    return 1;
+}
+
+void
+BurstControlHeader::Serialize(Buffer::Iterator start) const
+{
+    NS_LOG_FUNCTION(this << &start);
+    start.WriteU8(m_type);
+}
+
+uint32_t
+BurstControlHeader::Deserialize(Buffer::Iterator start)
+{
+    NS_LOG_FUNCTION(this << &start);
+    m_type = Type(start.ReadU8());
+    return GetSerializedSize();
+}
+
+NS_OBJECT_ENSURE_REGISTERED(BurstNackHeader);
+
+BurstNackHeader::BurstNackHeader()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+BurstNackHeader::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::BurstNackHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<BurstNackHeader>();
+    return tid;
+}
+
+TypeId
+BurstNackHeader::GetInstanceTypeId(void) const
+{
+    return GetTypeId();
+}
+
+void
+BurstNackHeader::SetBurstSeq(uint32_t burstSeq)
+{
+    m_burstSeq = burstSeq;
+}
+
+uint32_t
+BurstNackHeader::GetBurstSeq(void) const
+{
+    return m_burstSeq;
+}
+
+void
+BurstNackHeader::AddRange(uint32_t first, uint32_t count)
+{
+    m_ranges.push_back(std::make_pair(first, count));
+}
+
+const std::vector<BurstNackHeader::FragmentRange>&
+BurstNackHeader::GetRanges(void) const
+{
+    return m_ranges;
+}
+
+uint32_t
+BurstNackHeader::GetMissingFragments(void) const
+{
+    uint32_t missing = 0;
+    for (const auto& range : m_ranges)
+    {
+        missing += range.second;
+    }
+    return missing;
+}
+
+void
+BurstNackHeader::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    os << "(burstSeq=" << m_burstSeq << ", missing=[";
+    for (uint32_t i = 0; i < m_ranges.size(); i++)
+    {
+        os << (i > 0 ? ", " : "") << m_ranges[i].first << "+" << m_ranges[i].second;
+    }
+    os << "])";
+}
+
+uint32_t
+BurstNackHeader::GetSerializedSize(void) const
+{
+    return 4 + 2 + 8 * m_ranges.size();
+}
+
+void
+BurstNackHeader::Serialize(Buffer::Iterator start) const
+{
+    NS_LOG_FUNCTION(this << &start);
+    Buffer::Iterator i = start;
+    i.WriteHtonU32(m_burstSeq);
+    i.WriteHtonU16(m_ranges.size());
+    for (const auto& range : m_ranges)
+    {
+        i.WriteHtonU32(range.first);
+        i.WriteHtonU32(range.second);
+    }
+}
+
+uint32_t
+BurstNackHeader::Deserialize(Buffer::Iterator start)
+{
+    NS_LOG_FUNCTION(this << &start);
+    Buffer::Iterator i = start;
+    m_burstSeq = i.ReadNtohU32();
+    uint16_t nRanges = i.ReadNtohU16();
+    m_ranges.clear();
+    for (uint16_t r = 0; r < nRanges; r++)
+    {
+        uint32_t first = i.ReadNtohU32();
+        uint32_t count = i.ReadNtohU32();
+        m_ranges.push_back(std::make_pair(first, count));
+    }
+    return GetSerializedSize();
+}
+
+NS_OBJECT_ENSURE_REGISTERED(BurstFeedbackHeader);
+
+BurstFeedbackHeader::BurstFeedbackHeader()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+BurstFeedbackHeader::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::BurstFeedbackHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<BurstFeedbackHeader>();
+    return tid;
+}
+
+TypeId
+BurstFeedbackHeader::GetInstanceTypeId(void) const
+{
+    return GetTypeId();
+}
+
+void
+BurstFeedbackHeader::SetInterval(Time interval)
+{
+    m_interval = interval;
+}
+
+Time
+BurstFeedbackHeader::GetInterval(void) const
+{
+    return m_interval;
+}
+
+void
+BurstFeedbackHeader::SetReceivedBursts(uint32_t receivedBursts)
+{
+    m_receivedBursts = receivedBursts;
+}
+
+uint32_t
+BurstFeedbackHeader::GetReceivedBursts(void) const
+{
+    return m_receivedBursts;
+}
+
+void
+BurstFeedbackHeader::SetLostBursts(uint32_t lostBursts)
+{
+    m_lostBursts = lostBursts;
+}
+
+uint32_t
+BurstFeedbackHeader::GetLostBursts(void) const
+{
+    return m_lostBursts;
+}
+
+void
+BurstFeedbackHeader::SetReceivedBytes(uint64_t receivedBytes)
+{
+    m_receivedBytes = receivedBytes;
+}
+
+uint64_t
+BurstFeedbackHeader::GetReceivedBytes(void) const
+{
+    return m_receivedBytes;
+}
+
+void
+BurstFeedbackHeader::SetMeanDelay(Time meanDelay)
+{
+    m_meanDelay = meanDelay;
+}
+
+Time
+BurstFeedbackHeader::GetMeanDelay(void) const
+{
+    return m_meanDelay;
+}
+
+void
+BurstFeedbackHeader::SetDelayDelta(Time delayDelta)
+{
+    m_delayDelta = delayDelta;
+}
+
+Time
+BurstFeedbackHeader::GetDelayDelta(void) const
+{
+    return m_delayDelta;
+}
+
+double
+BurstFeedbackHeader::GetDeliveryRatio(void) const
+{
+    uint32_t bursts = m_receivedBursts + m_lostBursts;
+    if (bursts == 0)
+    {
+        return 1;
+    }
+    return double(m_receivedBursts) / bursts;
+}
+
+double
+BurstFeedbackHeader::GetDelayGradient(void) const
+{
+    if (!m_interval.IsStrictlyPositive())
+    {
+        return 0;
+    }
+    return m_delayDelta.GetSeconds() / m_interval.GetSeconds();
+}
+
+void
+BurstFeedbackHeader::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    os << "(interval=" << m_interval.As(Time::MS) << ", receivedBursts=" << m_receivedBursts
+       << ", lostBursts=" << m_lostBursts << ", receivedBytes=" << m_receivedBytes
+       << ", meanDelay=" << m_meanDelay.As(Time::MS)
+       << ", delayDelta=" << m_delayDelta.As(Time::MS) << ")";
+}
+
+uint32_t
+BurstFeedbackHeader::GetSerializedSize(void) const
+{
+    return 8 + 4 + 4 + 8 + 8 + 8;
+}
+
+void
+BurstFeedbackHeader::Serialize(Buffer::Iterator start) const
+{
+    NS_LOG_FUNCTION(this << &start);
+    Buffer::Iterator i = start;
+    i.WriteHtonU64(m_interval.GetNanoSeconds());
+    i.WriteHtonU32(m_receivedBursts);
+    i.WriteHtonU32(m_lostBursts);
+    i.WriteHtonU64(m_receivedBytes);
+    i.WriteHtonU64(m_meanDelay.GetNanoSeconds());
+    i.WriteHtonU64(m_delayDelta.GetNanoSeconds());
+}
+
+uint32_t
+BurstFeedbackHeader::Deserialize(Buffer::Iterator start)
+{
+    NS_LOG_FUNCTION(this << &start);
+    Buffer::Iterator i = start;
+    m_interval = NanoSeconds(int64_t(i.ReadNtohU64()));
+    m_receivedBursts = i.ReadNtohU32();
+    m_lostBursts = i.ReadNtohU32();
+    m_receivedBytes = i.ReadNtohU64();
+    m_meanDelay = NanoSeconds(int64_t(i.ReadNtohU64()));
+    m_delayDelta = NanoSeconds(int64_t(i.ReadNtohU64()));
+    return GetSerializedSize();
+}
+
+} // namespace ns3
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ *   SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_CONTROL_HEADER_H
+#define BURST_CONTROL_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup applications
+ * @brief Header identifying the type of a control packet sent back by a BurstSink to a
+ * BurstyApplication
+ *
+ * Control packets travel in the reverse direction of the bursts, on the same
+ * UDP flow. This header precedes the header specific to each control packet
+ * type.
+ */
+class BurstControlHeader : public Header
+{
+  public:
+    /**
+     * @brief The type of control packet
+     */
+    enum Type : uint8_t
+    {
+        Nack = 0,    //!< Missing fragments of a burst, followed by a BurstNackHeader
+        Feedback = 1 //!< Periodic reception report, followed by a BurstFeedbackHeader
+    };
+
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+
+    /**
+     * @brief constructor
+     * @param type the type of control packet
+     */
+    BurstControlHeader(Type type = Nack);
+
+    /**
+     * @brief Set the type of control packet
+     * @param type the type of control packet
+     */
+    void SetType(Type type);
+
+    /**
+     * @brief Get the type of control packet
+     * @return the type of control packet
+     */
+    Type GetType(void) const;
+
+    // Inherited
+    virtual TypeId GetInstanceTypeId(void) const override;
+    virtual void Print(std::ostream& os) const override;
+    virtual uint32_t GetSerializedSize(void) const override;
+    virtual void Serialize(Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(Buffer::Iterator start) override;
+
+  private:
+    Type m_type; //!< The type of control packet
+};
+
+/**
+ * @ingroup applications
+ * @brief Negative acknowledgment listing the missing fragments of a burst
+ *
+ * Missing fragments are listed as ranges of consecutive fragment sequence
+ * numbers, so that a NACK remains small even when many consecutive fragments
+ * are lost.
+ */
+class BurstNackHeader : public Header
+{
+  public:
+    /**
+     * @brief A range of missing fragments: first fragment sequence number and number of fragments
+     */
+    typedef std::pair<uint32_t, uint32_t> FragmentRange;
+
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+
+    /**
+     * @brief constructor
+     */
+    BurstNackHeader();
+
+    /**
+     * @brief Set the sequence number of the burst
+     * @param burstSeq the sequence number of the burst
+     */
+    void SetBurstSeq(uint32_t burstSeq);
+
+    /**
+     * @brief Get the sequence number of the burst
+     * @return the sequence number of the burst
+     */
+    uint32_t GetBurstSeq(void) const;
+
+    /**
+     * @brief Add a range of missing fragments
+     * @param first the sequence number of the first missing fragment
+     * @param count the number of consecutive missing fragments
+     */
+    void AddRange(uint32_t first, uint32_t count);
+
+    /**
+     * @brief Get the ranges of missing fragments
+     * @return the ranges of missing fragments
+     */
+    const std::vector<FragmentRange>& GetRanges(void) const;
+
+    /**
+     * @brief Get the total number of missing fragments
+     * @return the total number of missing fragments
+     */
+    uint32_t GetMissingFragments(void) const;
+
+    // Inherited
+    virtual TypeId GetInstanceTypeId(void) const override;
+    virtual void Print(std::ostream& os) const override;
+    virtual uint32_t GetSerializedSize(void) const override;
+    virtual void Serialize(Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(Buffer::Iterator start) override;
+
+  private:
+    uint32_t m_burstSeq{0};              //!< The sequence number of the burst
+    std::vector<FragmentRange> m_ranges; //!< The ranges of missing fragments
+};
+
+/**
+ * @ingroup applications
+ * @brief Periodic reception report of a flow of bursts
+ *
+ * Summarizes the bursts received by a BurstSink during the last feedback
+ * interval: received and lost bursts, received bytes, the mean one-way delay
+ * of the fragments, computed from the time stamps of their SeqTsSizeHeader,
+ * and its variation with respect to the previous interval. Rate controllers
+ * at the source derive the delivery ratio, the receive rate, and the delay
+ * gradient from these fields.
+ */
+class BurstFeedbackHeader : public Header
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+
+    /**
+     * @brief constructor
+     */
+    BurstFeedbackHeader();
+
+    /**
+     * @brief Set the duration of the feedback interval
+     * @param interval the duration of the feedback interval
+     */
+    void SetInterval(Time interval);
+
+    /**
+     * @brief Get the duration of the feedback interval
+     * @return the duration of the feedback interval
+     */
+    Time GetInterval(void) const;
+
+    /**
+     * @brief Set the number of bursts received during the interval
+     * @param receivedBursts the number of bursts received
+     */
+    void SetReceivedBursts(uint32_t receivedBursts);
+
+    /**
+     * @brief Get the number of bursts received during the interval
+     * @return the number of bursts received
+     */
+    uint32_t GetReceivedBursts(void) const;
+
+    /**
+     * @brief Set the number of incomplete bursts discarded during the interval
+     * @param lostBursts the number of incomplete bursts discarded
+     */
+    void SetLostBursts(uint32_t lostBursts);
+
+    /**
+     * @brief Get the number of incomplete bursts discarded during the interval
+     * @return the number of incomplete bursts discarded
+     */
+    uint32_t GetLostBursts(void) const;
+
+    /**
+     * @brief Set the number of bytes received during the interval
+     * @param receivedBytes the number of bytes received
+     */
+    void SetReceivedBytes(uint64_t receivedBytes);
+
+    /**
+     * @brief Get the number of bytes received during the interval
+     * @return the number of bytes received
+     */
+    uint64_t GetReceivedBytes(void) const;
+
+    /**
+     * @brief Set the mean one-way delay of the fragments received during the interval
+     * @param meanDelay the mean one-way delay
+     */
+    void SetMeanDelay(Time meanDelay);
+
+    /**
+     * @brief Get the mean one-way delay of the fragments received during the interval
+     * @return the mean one-way delay
+     */
+    Time GetMeanDelay(void) const;
+
+    /**
+     * @brief Set the variation of the mean one-way delay with respect to the previous interval
+     * @param delayDelta the variation of the mean one-way delay
+     */
+    void SetDelayDelta(Time delayDelta);
+
+    /**
+     * @brief Get the variation of the mean one-way delay with respect to the previous interval
+     * @return the variation of the mean one-way delay
+     */
+    Time GetDelayDelta(void) const;
+
+    /**
+     * @brief Get the fraction of bursts received among those received or lost
+     * @return the delivery ratio, 1 if no burst was received nor lost
+     */
+    double GetDeliveryRatio(void) const;
+
+    /**
+     * @brief Get the variation of the one-way delay per unit of time
+     * @return the delay gradient [s/s]
+     */
+    double GetDelayGradient(void) const;
+
+    // Inherited
+    virtual TypeId GetInstanceTypeId(void) const override;
+    virtual void Print(std::ostream& os) const override;
+    virtual uint32_t GetSerializedSize(void) const override;
+    virtual void Serialize(Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(Buffer::Iterator start) override;
+
+  private:
+    Time m_interval;              //!< The duration of the feedback interval
+    uint32_t m_receivedBursts{0}; //!< The number of bursts received
+    uint32_t m_lostBursts{0};     //!< The number of incomplete bursts discarded
+    uint64_t m_receivedBytes{0};  //!< The number of bytes received
+    Time m_meanDelay;             //!< The mean one-way delay of the fragments received
+    Time m_delayDelta;            //!< The variation of the mean one-way delay
+};
+
+} // namespace ns3
+
+#endif /* BURST_CONTROL_HEADER_H */
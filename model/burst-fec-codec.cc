@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-fec-codec.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstFecCodec");
+
+namespace
+{
+
+/**
+ * Logarithm and exponential tables of GF(256), generated by the primitive
+ * polynomial x^8 + x^4 + x^3 + x^2 + 1
+ */
+struct GfTables
+{
+    GfTables()
+    {
+        uint32_t x = 1;
+        for (uint32_t i = 0; i < 255; i++)
+        {
+            exp[i] = x;
+            exp[i + 255] = x;
+            log[x] = i;
+            x <<= 1;
+            if (x & 0x100)
+            {
+                x ^= 0x11d;
+            }
+        }
+        log[0] = 0;
+    }
+
+    uint8_t exp[510]; //!< Exponential table, doubled to avoid the modulo
+    uint8_t log[256]; //!< Logarithm table
+};
+
+/**
+ * @return the GF(256) tables, built on first use
+ */
+const GfTables&
+GetGfTables()
+{
+    static const GfTables tables;
+    return tables;
+}
+
+} // namespace
+
+BurstFecCodec::BurstFecCodec()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BurstFecCodec::Configure(Scheme scheme, uint32_t dataShards, uint32_t parityShards)
+{
+    NS_LOG_FUNCTION(this << scheme << dataShards << parityShards);
+
+    m_scheme = scheme;
+    m_dataShards = dataShards;
+    m_parityShards = scheme == None ? 0 : parityShards;
+    m_groups = 1;
+
+    if (m_scheme == Xor && m_parityShards > 0)
+    {
+        NS_ABORT_MSG_IF(m_parityShards > m_dataShards,
+                        "XOR FEC cannot use more parity shards (" << m_parityShards
+                                                                  << ") than data shards ("
+                                                                  << m_dataShards << ")");
+        m_groups = m_parityShards;
+    }
+    else if (m_scheme == ReedSolomon)
+    {
+        // smallest number of groups such that each codeword fits GF(256)
+        m_groups = std::max<uint32_t>(1, (m_dataShards + m_parityShards + 255) / 256);
+        while (GetGroupDataShards(0) + GetGroupParityShards(0) > 256)
+        {
+            m_groups++;
+        }
+    }
+}
+
+BurstFecCodec::Scheme
+BurstFecCodec::GetScheme() const
+{
+    return m_scheme;
+}
+
+uint32_t
+BurstFecCodec::GetDataShards() const
+{
+    return m_dataShards;
+}
+
+uint32_t
+BurstFecCodec::GetParityShards() const
+{
+    return m_parityShards;
+}
+
+uint32_t
+BurstFecCodec::GetGroups() const
+{
+    return m_groups;
+}
+
+uint32_t
+BurstFecCodec::GetGroup(uint32_t shard) const
+{
+    if (shard < m_dataShards)
+    {
+        return shard % m_groups;
+    }
+    return (shard - m_dataShards) % m_groups;
+}
+
+uint32_t
+BurstFecCodec::GetGroupDataShards(uint32_t group) const
+{
+    return m_dataShards / m_groups + (group < m_dataShards % m_groups ? 1 : 0);
+}
+
+uint32_t
+BurstFecCodec::GetGroupParityShards(uint32_t group) const
+{
+    return m_parityShards / m_groups + (group < m_parityShards % m_groups ? 1 : 0);
+}
+
+uint8_t
+BurstFecCodec::GetCoefficient(uint32_t group, uint32_t parityIndex, uint32_t dataIndex) const
+{
+    if (m_scheme == Xor)
+    {
+        return 1;
+    }
+
+    // Cauchy matrix 1 / (x_i + y_j), with x_i = k + i and y_j = j, for a group of k data shards
+    uint32_t k = GetGroupDataShards(group);
+    return GfInv((k + parityIndex) ^ dataIndex);
+}
+
+void
+BurstFecCodec::Encode(const uint8_t* data, uint8_t* parity, uint32_t shardSize) const
+{
+    NS_LOG_FUNCTION(this << shardSize);
+
+    std::memset(parity, 0, size_t(m_parityShards) * shardSize);
+    for (uint32_t p = 0; p < m_parityShards; p++)
+    {
+        uint32_t group = p % m_groups;
+        uint32_t k = GetGroupDataShards(group);
+        for (uint32_t l = 0; l < k; l++)
+        {
+            uint32_t j = group + l * m_groups;
+            MulAdd(parity + size_t(p) * shardSize,
+                   data + size_t(j) * shardSize,
+                   GetCoefficient(group, p / m_groups, l),
+                   shardSize);
+        }
+    }
+}
+
+bool
+BurstFecCodec::Decode(uint8_t* data,
+                      const uint8_t* parity,
+                      const std::vector<bool>& received,
+                      uint32_t shardSize) const
+{
+    NS_LOG_FUNCTION(this << shardSize);
+    NS_ASSERT(received.size() == m_dataShards + m_parityShards);
+
+    std::vector<uint32_t> erasures;
+    std::vector<uint32_t> parities;
+    std::vector<uint8_t> syndromes;
+    std::vector<uint8_t> matrix;
+    for (uint32_t group = 0; group < m_groups; group++)
+    {
+        uint32_t k = GetGroupDataShards(group);
+        uint32_t m = GetGroupParityShards(group);
+
+        erasures.clear();
+        for (uint32_t l = 0; l < k; l++)
+        {
+            if (!received[group + l * m_groups])
+            {
+                erasures.push_back(l);
+            }
+        }
+        if (erasures.empty())
+        {
+            continue;
+        }
+
+        parities.clear();
+        for (uint32_t i = 0; i < m && parities.size() < erasures.size(); i++)
+        {
+            if (received[m_dataShards + group + i * m_groups])
+            {
+                parities.push_back(i);
+            }
+        }
+        if (parities.size() < erasures.size())
+        {
+            NS_LOG_LOGIC("Group " << group << ": " << erasures.size() << " erasures, only "
+                                  << parities.size() << " parity shards received");
+            return false;
+        }
+
+        // syndromes: received parity shards minus the contribution of the received data shards
+        uint32_t e = erasures.size();
+        syndromes.assign(size_t(e) * shardSize, 0);
+        for (uint32_t r = 0; r < e; r++)
+        {
+            uint8_t* syndrome = syndromes.data() + size_t(r) * shardSize;
+            std::memcpy(syndrome,
+                        parity + size_t(group + parities[r] * m_groups) * shardSize,
+                        shardSize);
+            for (uint32_t l = 0; l < k; l++)
+            {
+                uint32_t j = group + l * m_groups;
+                if (received[j])
+                {
+                    MulAdd(syndrome,
+                           data + size_t(j) * shardSize,
+                           GetCoefficient(group, parities[r], l),
+                           shardSize);
+                }
+            }
+        }
+
+        // invert the e x e submatrix of the generator with Gauss-Jordan elimination
+        matrix.assign(size_t(e) * 2 * e, 0);
+        for (uint32_t r = 0; r < e; r++)
+        {
+            for (uint32_t c = 0; c < e; c++)
+            {
+                matrix[r * 2 * e + c] = GetCoefficient(group, parities[r], erasures[c]);
+            }
+            matrix[r * 2 * e + e + r] = 1;
+        }
+        for (uint32_t c = 0; c < e; c++)
+        {
+            uint32_t pivot = c;
+            while (pivot < e && matrix[pivot * 2 * e + c] == 0)
+            {
+                pivot++;
+            }
+            NS_ABORT_MSG_IF(pivot == e, "Singular FEC decoding matrix");
+            if (pivot != c)
+            {
+                std::swap_ranges(matrix.begin() + pivot * 2 * e,
+                                 matrix.begin() + (pivot + 1) * 2 * e,
+                                 matrix.begin() + c * 2 * e);
+            }
+            uint8_t inv = GfInv(matrix[c * 2 * e + c]);
+            for (uint32_t x = 0; x < 2 * e; x++)
+            {
+                matrix[c * 2 * e + x] = GfMul(matrix[c * 2 * e + x], inv);
+            }
+            for (uint32_t r = 0; r < e; r++)
+            {
+                uint8_t factor = matrix[r * 2 * e + c];
+                if (r == c || factor == 0)
+                {
+                    continue;
+                }
+                for (uint32_t x = 0; x < 2 * e; x++)
+                {
+                    matrix[r * 2 * e + x] ^= GfMul(factor, matrix[c * 2 * e + x]);
+                }
+            }
+        }
+
+        // recover the missing data shards
+        for (uint32_t c = 0; c < e; c++)
+        {
+            uint8_t* shard = data + size_t(group + erasures[c] * m_groups) * shardSize;
+            std::memset(shard, 0, shardSize);
+            for (uint32_t r = 0; r < e; r++)
+            {
+                MulAdd(shard,
+                       syndromes.data() + size_t(r) * shardSize,
+                       matrix[c * 2 * e + e + r],
+                       shardSize);
+            }
+        }
+    }
+
+    return true;
+}
+
+void
+BurstFecCodec::MulAdd(uint8_t* dst, const uint8_t* src, uint8_t coef, uint32_t size)
+{
+    if (coef == 0)
+    {
+        return;
+    }
+
+    uint32_t i = 0;
+    if (coef == 1)
+    {
+        for (; i < size; i++)
+        {
+            dst[i] ^= src[i];
+        }
+        return;
+    }
+
+    // products of the coefficient with the low and high nibbles of a byte
+    uint8_t lowTable[16];
+    uint8_t highTable[16];
+    for (uint8_t x = 0; x < 16; x++)
+    {
+        lowTable[x] = GfMul(coef, x);
+        highTable[x] = GfMul(coef, x << 4);
+    }
+
+#ifdef __SSSE3__
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowTable));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(highTable));
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i productLow = _mm_shuffle_epi8(low, _mm_and_si128(s, mask));
+        __m128i productHigh = _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+        d = _mm_xor_si128(d, _mm_xor_si128(productLow, productHigh));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+    }
+#endif
+
+    for (; i < size; i++)
+    {
+        dst[i] ^= lowTable[src[i] & 0x0f] ^ highTable[src[i] >> 4];
+    }
+}
+
+uint8_t
+BurstFecCodec::GfMul(uint8_t a, uint8_t b)
+{
+    if (a == 0 || b == 0)
+    {
+        return 0;
+    }
+    const GfTables& tables = GetGfTables();
+    return tables.exp[tables.log[a] + tables.log[b]];
+}
+
+uint8_t
+BurstFecCodec::GfInv(uint8_t a)
+{
+    NS_ASSERT_MSG(a != 0, "Zero has no inverse in GF(256)");
+    const GfTables& tables = GetGfTables();
+    return tables.exp[255 - tables.log[a]];
+}
+
+} // namespace ns3
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_FEC_CODEC_H
+#define BURST_FEC_CODEC_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup applications
+ *
+ * @brief Systematic erasure code protecting the fragments of a burst
+ *
+ * A burst of K data fragments is protected by M parity fragments. Data
+ * fragments are seen as shards of equal size, the shorter ones being
+ * virtually padded with zeros, and each parity shard is a linear
+ * combination over GF(256) of the data shards.
+ *
+ * Shards are interleaved into G groups, each one forming an independent
+ * codeword: data shard j and parity shard p belong to groups j % G and
+ * p % G, respectively. A group with k data and m parity shards can be
+ * recovered as soon as any k of its k+m shards are received.
+ *
+ * Two schemes are supported:
+ * - Xor: each group has a single parity shard, i.e., the XOR of its data
+ *   shards, and G = M. Up to one lost shard per group can be recovered.
+ * - ReedSolomon: a systematic code with a Cauchy generator matrix, which is
+ *   maximum distance separable. A single group is used as long as
+ *   K + M <= 256, otherwise the smallest number of groups fitting the field
+ *   size is used. Any K out of K + M shards are enough to recover the burst
+ *   with a single group.
+ *
+ * The GF(256) multiply-accumulate kernel splits each byte into nibbles and
+ * uses two 16-entry product tables per coefficient, the same layout used by
+ * byte-shuffle SIMD instructions: if SSSE3 is available at compile time, 16
+ * bytes are processed per instruction.
+ */
+class BurstFecCodec
+{
+  public:
+    /**
+     * @brief The FEC scheme
+     */
+    enum Scheme
+    {
+        None = 0,   //!< No parity fragments
+        Xor,        //!< One XOR parity fragment per group
+        ReedSolomon //!< Systematic Reed-Solomon code over GF(256)
+    };
+
+    BurstFecCodec();
+
+    /**
+     * @brief Configure the code for a burst
+     * @param scheme the FEC scheme
+     * @param dataShards the number of data shards K
+     * @param parityShards the number of parity shards M
+     */
+    void Configure(Scheme scheme, uint32_t dataShards, uint32_t parityShards);
+
+    /**
+     * @return the FEC scheme
+     */
+    Scheme GetScheme() const;
+
+    /**
+     * @return the number of data shards
+     */
+    uint32_t GetDataShards() const;
+
+    /**
+     * @return the number of parity shards
+     */
+    uint32_t GetParityShards() const;
+
+    /**
+     * @return the number of interleaved groups
+     */
+    uint32_t GetGroups() const;
+
+    /**
+     * @brief Get the group of a shard
+     * @param shard the index of the shard: data shards first, then parity shards
+     * @return the group of the shard
+     */
+    uint32_t GetGroup(uint32_t shard) const;
+
+    /**
+     * @brief Get the number of data shards of a group
+     * @param group the group
+     * @return the number of data shards of the group
+     */
+    uint32_t GetGroupDataShards(uint32_t group) const;
+
+    /**
+     * @brief Compute the parity shards
+     * @param data the data shards, stored contiguously
+     * @param parity the buffer where the parity shards are stored contiguously
+     * @param shardSize the size of each shard [B]
+     */
+    void Encode(const uint8_t* data, uint8_t* parity, uint32_t shardSize) const;
+
+    /**
+     * @brief Recover the missing data shards in place
+     * @param data the data shards, stored contiguously, missing ones included
+     * @param parity the parity shards, stored contiguously, missing ones included
+     * @param received whether each shard has been received, indexed as in GetGroup
+     * @param shardSize the size of each shard [B]
+     * @return false if too many shards are missing to recover the data shards
+     */
+    bool Decode(uint8_t* data,
+                const uint8_t* parity,
+                const std::vector<bool>& received,
+                uint32_t shardSize) const;
+
+    /**
+     * @brief Multiply a shard by a coefficient and accumulate it, i.e., dst += coef * src
+     * @param dst the accumulator
+     * @param src the shard to multiply
+     * @param coef the coefficient
+     * @param size the size of the shards [B]
+     */
+    static void MulAdd(uint8_t* dst, const uint8_t* src, uint8_t coef, uint32_t size);
+
+    /**
+     * @brief Multiply two elements of GF(256)
+     * @param a the first element
+     * @param b the second element
+     * @return the product a * b
+     */
+    static uint8_t GfMul(uint8_t a, uint8_t b);
+
+    /**
+     * @brief Invert a non-zero element of GF(256)
+     * @param a the element
+     * @return the inverse of a
+     */
+    static uint8_t GfInv(uint8_t a);
+
+  private:
+    /**
+     * @brief Get the coefficient of a data shard in a parity shard of the same group
+     * @param group the group
+     * @param parityIndex the index of the parity shard within its group
+     * @param dataIndex the index of the data shard within its group
+     * @return the coefficient of the generator matrix
+     */
+    uint8_t GetCoefficient(uint32_t group, uint32_t parityIndex, uint32_t dataIndex) const;
+
+    /**
+     * @brief Get the number of parity shards of a group
+     * @param group the group
+     * @return the number of parity shards of the group
+     */
+    uint32_t GetGroupParityShards(uint32_t group) const;
+
+    Scheme m_scheme{None};      //!< FEC scheme
+    uint32_t m_dataShards{0};   //!< Number of data shards
+    uint32_t m_parityShards{0}; //!< Number of parity shards
+    uint32_t m_groups{1};       //!< Number of interleaved groups
+};
+
+} // namespace ns3
+
+#endif /* BURST_FEC_CODEC_H */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-flow-key.h"
+
+#include "ns3/abort.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+namespace ns3
+{
+
+FlowKey::FlowKey()
+    : m_address{0},
+      m_port(0),
+      m_family(None)
+{
+}
+
+FlowKey::FlowKey(const Address& address)
+    : m_address{0}
+{
+    if (InetSocketAddress::IsMatchingType(address))
+    {
+        InetSocketAddress inetAddress = InetSocketAddress::ConvertFrom(address);
+        inetAddress.GetIpv4().Serialize(m_address);
+        m_port = inetAddress.GetPort();
+        m_family = Ipv4;
+    }
+    else if (Inet6SocketAddress::IsMatchingType(address))
+    {
+        Inet6SocketAddress inet6Address = Inet6SocketAddress::ConvertFrom(address);
+        inet6Address.GetIpv6().Serialize(m_address);
+        m_port = inet6Address.GetPort();
+        m_family = Ipv6;
+    }
+    else
+    {
+        NS_ABORT_MSG("Flows can only be identified by an InetSocketAddress or an "
+                     "Inet6SocketAddress, instead found "
+                     << address);
+    }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const FlowKey& key)
+{
+    switch (key.m_family)
+    {
+    case FlowKey::Ipv4:
+        os << Ipv4Address::Deserialize(key.m_address) << ":" << key.m_port;
+        break;
+    case FlowKey::Ipv6:
+        os << "[" << Ipv6Address::Deserialize(key.m_address) << "]:" << key.m_port;
+        break;
+    default:
+        os << "(none)";
+        break;
+    }
+    return os;
+}
+
+} // namespace ns3
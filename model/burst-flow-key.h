@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_FLOW_KEY_H
+#define BURST_FLOW_KEY_H
+
+#include "ns3/address.h"
+
+#include <cstring>
+#include <ostream>
+
+namespace ns3
+{
+
+/**
+ * @ingroup burstsink
+ *
+ * @brief Key identifying a flow of bursts received by a BurstSink
+ *
+ * A flow is identified by the IPv4 or IPv6 address and the port of its
+ * source, as found in an InetSocketAddress or an Inet6SocketAddress, so
+ * that multiple BurstyApplications on the same node are told apart.
+ *
+ * The key is a small, fixed-size value: building it from an Address, and
+ * comparing or hashing it, does not allocate memory, so that a BurstSink can
+ * demultiplex thousands of concurrent flows at a low cost per fragment.
+ */
+class FlowKey
+{
+  public:
+    /**
+     * @brief The address family of the flow source
+     */
+    enum Family : uint8_t
+    {
+        None = 0, //!< Default-constructed key, matching no flow
+        Ipv4,     //!< IPv4 address and port
+        Ipv6      //!< IPv6 address and port
+    };
+
+    FlowKey();
+
+    /**
+     * @brief Build the key of the flow from a given source
+     * @param address the source address, either an InetSocketAddress or an Inet6SocketAddress
+     */
+    explicit FlowKey(const Address& address);
+
+    /**
+     * @brief Get the address family of the flow source
+     * @return the address family
+     */
+    Family GetFamily(void) const
+    {
+        return m_family;
+    }
+
+    /**
+     * @brief Get the port of the flow source
+     * @return the port
+     */
+    uint16_t GetPort(void) const
+    {
+        return m_port;
+    }
+
+    /**
+     * @brief Compute the hash of the key
+     * @return the hash of the key
+     *
+     * The 16 address bytes are folded into 64 bits together with the port
+     * and the family, then mixed with the finalizer of splitmix64, so that
+     * sources differing only in the last bits of the address or in the port
+     * are spread over the buckets.
+     */
+    size_t GetHash(void) const
+    {
+        uint64_t hi;
+        uint64_t lo;
+        std::memcpy(&hi, m_address, sizeof(hi));
+        std::memcpy(&lo, m_address + sizeof(hi), sizeof(lo));
+        uint64_t h = hi ^ (lo * 0x9e3779b97f4a7c15ULL) ^ (uint64_t(m_port) << 8) ^ m_family;
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return size_t(h);
+    }
+
+    /**
+     * @brief Compare two keys
+     * @param other the other key
+     * @return true if both keys identify the same flow
+     */
+    bool operator==(const FlowKey& other) const
+    {
+        return m_family == other.m_family && m_port == other.m_port &&
+               std::memcmp(m_address, other.m_address, sizeof(m_address)) == 0;
+    }
+
+    /**
+     * @brief Compare two keys
+     * @param other the other key
+     * @return true if the keys identify different flows
+     */
+    bool operator!=(const FlowKey& other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    friend std::ostream& operator<<(std::ostream& os, const FlowKey& key);
+
+    uint8_t m_address[16]; //!< IPv6 address, or IPv4 address in the first 4 bytes
+    uint16_t m_port;       //!< Port of the flow source
+    Family m_family;       //!< Address family of the flow source
+};
+
+/**
+ * @brief Hashing for the FlowKey class
+ * Needed to make FlowKey the key of an unordered map.
+ */
+struct FlowKeyHash
+{
+    /**
+     * @brief operator ()
+     * @param key the key of which calculate the hash
+     * @return the hash of key
+     */
+    size_t operator()(const FlowKey& key) const
+    {
+        return key.GetHash();
+    }
+};
+
+/**
+ * @brief Stream insertion operator
+ * @param os the stream
+ * @param key the flow key
+ * @return a reference to the stream
+ */
+std::ostream& operator<<(std::ostream& os, const FlowKey& key);
+
+} // namespace ns3
+
+#endif /* BURST_FLOW_KEY_H */
@@ -11,6 +11,7 @@
 #include "burst-generator.h"
 
 #include "ns3/log.h"
+#include "ns3/nstime.h"
 
 namespace ns3
 {
@@ -35,6 +36,24 @@ BurstGenerator::GetTypeId()
     return tid;
 }
 
+std::pair<uint64_t, Time>
+BurstGenerator::GenerateLargeBurst(void)
+{
+    return GenerateBurst();
+}
+
+uint8_t
+BurstGenerator::GetBurstImportance(void) const
+{
+    return 0;
+}
+
+int64_t
+BurstGenerator::AssignStreams(int64_t stream)
+{
+    return 0;
+}
+
 void
 BurstGenerator::DoDispose()
 {
@@ -31,6 +31,17 @@ class Time;
  * size and the time before the next burst
  * - HasNextBurst: to check whether GenerateBurst can be safely called.
  *
+ * Bursts larger than 4 GB can be generated by overriding GenerateLargeBurst,
+ * which by default widens the burst size returned by GenerateBurst.
+ *
+ * Generators using random variables override AssignStreams, so that
+ * BurstyHelper::AssignStreams can fix their streams whatever their type.
+ *
+ * Generators can also classify the importance of each burst, e.g., I-frames
+ * vs P-frames, or base vs enhancement layers, by overriding
+ * GetBurstImportance, which BurstyApplication maps to the QoS priority of
+ * the fragments.
+ *
  * The interface is meant to allow for great flexibility in its child
  * classes: such classes can include complex behavior, such as arbitrary
  * probability distributions for burst size and period, correlations
@@ -58,6 +69,24 @@ class BurstGenerator : public Object
      */
     virtual std::pair<uint32_t, Time> GenerateBurst(void) = 0;
 
+    /**
+     * Generate the next burst, possibly larger than 4 GB.
+     * BurstyApplication uses this method: by default, it returns the burst
+     * generated by GenerateBurst, and generators of larger bursts, e.g.,
+     * aggregating several frames, override it.
+     *
+     * @return pair with burst size [B] and the time before the next burst
+     */
+    virtual std::pair<uint64_t, Time> GenerateLargeBurst(void);
+
+    /**
+     * Get the importance class of the last generated burst, higher for more
+     * important bursts. By default, all bursts have importance 0.
+     *
+     * @return the importance class of the last generated burst
+     */
+    virtual uint8_t GetBurstImportance(void) const;
+
     /**
      * Check whether a next burst can be generated.
      * If not, an error may occur.
@@ -66,6 +95,15 @@ class BurstGenerator : public Object
      */
     virtual bool HasNextBurst(void) = 0;
 
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by the generator. By default, the generator uses none.
+     *
+     * @param stream first stream index to use
+     * @return the number of stream indices assigned by the generator
+     */
+    virtual int64_t AssignStreams(int64_t stream);
+
   protected:
     virtual void DoDispose(void) override;
 };
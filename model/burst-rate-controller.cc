@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-rate-controller.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/trace-source-accessor.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstRateController");
+
+NS_OBJECT_ENSURE_REGISTERED(BurstRateController);
+
+TypeId
+BurstRateController::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::BurstRateController")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<BurstRateController>()
+            .AddAttribute("MinDataRate",
+                          "The minimum target data rate.",
+                          DataRateValue(DataRate("5Mbps")),
+                          MakeDataRateAccessor(&BurstRateController::m_minDataRate),
+                          MakeDataRateChecker())
+            .AddAttribute("MaxDataRate",
+                          "The maximum target data rate.",
+                          DataRateValue(DataRate("100Mbps")),
+                          MakeDataRateAccessor(&BurstRateController::m_maxDataRate),
+                          MakeDataRateChecker())
+            .AddAttribute("TargetDelay",
+                          "The mean one-way delay above which the link is considered overused.",
+                          TimeValue(MilliSeconds(20)),
+                          MakeTimeAccessor(&BurstRateController::m_targetDelay),
+                          MakeTimeChecker())
+            .AddAttribute("DelayGradientThreshold",
+                          "The delay gradient [s/s] above which the link is considered overused.",
+                          DoubleValue(0.01),
+                          MakeDoubleAccessor(&BurstRateController::m_delayGradientThreshold),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("IncreaseFactor",
+                          "The multiplicative increase of the rate for each feedback received "
+                          "while the link is not overused.",
+                          DoubleValue(1.05),
+                          MakeDoubleAccessor(&BurstRateController::m_increaseFactor),
+                          MakeDoubleChecker<double>(1))
+            .AddAttribute("DecreaseFactor",
+                          "The fraction of the receive rate used as new rate when the link is "
+                          "overused.",
+                          DoubleValue(0.85),
+                          MakeDoubleAccessor(&BurstRateController::m_decreaseFactor),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddTraceSource("RateUpdate",
+                            "The target data rate has been updated",
+                            MakeTraceSourceAccessor(&BurstRateController::m_rateUpdateTrace),
+                            "ns3::BurstRateController::RateUpdateCallback");
+    return tid;
+}
+
+BurstRateController::BurstRateController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BurstRateController::~BurstRateController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+DataRate
+BurstRateController::Update(const BurstFeedbackHeader& feedback, DataRate currentRate)
+{
+    NS_LOG_FUNCTION(this << feedback << currentRate);
+
+    if (!feedback.GetInterval().IsStrictlyPositive() ||
+        (feedback.GetReceivedBytes() == 0 && feedback.GetLostBursts() == 0))
+    {
+        NS_LOG_LOGIC("No traffic reported: holding rate " << currentRate);
+        return currentRate;
+    }
+
+    double current = currentRate.GetBitRate();
+    double receiveRate = feedback.GetReceivedBytes() * 8.0 / feedback.GetInterval().GetSeconds();
+    double gradient = feedback.GetDelayGradient();
+
+    // delay-based estimate
+    double delayBasedRate = current;
+    if (feedback.GetMeanDelay() > m_targetDelay || gradient > m_delayGradientThreshold)
+    {
+        NS_LOG_LOGIC("Overuse: mean delay " << feedback.GetMeanDelay().As(Time::MS)
+                                            << ", gradient " << gradient);
+        delayBasedRate = m_decreaseFactor * std::min(receiveRate, current);
+    }
+    else if (gradient < -m_delayGradientThreshold)
+    {
+        NS_LOG_LOGIC("Underuse: gradient " << gradient << ", holding rate");
+    }
+    else
+    {
+        // do not run too far ahead of what the receiver actually gets
+        delayBasedRate = std::min(current * m_increaseFactor, std::max(current, 1.5 * receiveRate));
+    }
+
+    // loss-based estimate
+    double lossRatio = 1 - feedback.GetDeliveryRatio();
+    double lossBasedRate = current;
+    if (lossRatio > 0.1)
+    {
+        NS_LOG_LOGIC("Loss ratio " << lossRatio << ": decreasing rate");
+        lossBasedRate = current * (1 - 0.5 * lossRatio);
+    }
+    else if (lossRatio < 0.02)
+    {
+        lossBasedRate = current * m_increaseFactor;
+    }
+
+    double newRate = std::min(delayBasedRate, lossBasedRate);
+    newRate = std::max<double>(newRate, m_minDataRate.GetBitRate());
+    newRate = std::min<double>(newRate, m_maxDataRate.GetBitRate());
+
+    DataRate newDataRate(static_cast<uint64_t>(newRate));
+    NS_LOG_DEBUG("Rate update: " << currentRate << " -> " << newDataRate
+                                 << " (receive rate=" << receiveRate << "bps, loss=" << lossRatio
+                                 << ", mean delay=" << feedback.GetMeanDelay().As(Time::MS)
+                                 << ", gradient=" << gradient << ")");
+    m_rateUpdateTrace(currentRate, newDataRate);
+    return newDataRate;
+}
+
+} // namespace ns3
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_RATE_CONTROLLER_H
+#define BURST_RATE_CONTROLLER_H
+
+#include "burst-control-header.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3
+{
+
+/**
+ * @ingroup applications
+ *
+ * @brief Closed-loop rate controller driven by BurstSink feedback
+ *
+ * The controller updates the target data rate of a BurstyApplication every
+ * time a BurstFeedbackHeader is received, combining a delay-based and a
+ * loss-based estimate, similarly to Google Congestion Control (GCC) and
+ * SCReAM:
+ * - Delay-based: if the mean one-way delay exceeds the TargetDelay, or the
+ *   delay gradient exceeds the DelayGradientThreshold, the link is
+ *   overused and the rate is reduced to DecreaseFactor times the receive
+ *   rate. If the delay gradient is below -DelayGradientThreshold, queues are
+ *   draining and the rate is held. Otherwise, the rate is multiplied by the
+ *   IncreaseFactor, without exceeding 1.5 times the receive rate.
+ * - Loss-based: if more than 10% of the bursts are lost, the rate is reduced
+ *   by half the loss ratio; if less than 2% of the bursts are lost, the rate
+ *   is multiplied by the IncreaseFactor; otherwise it is held.
+ *
+ * The new rate is the minimum between the two estimates, bounded by the
+ * MinDataRate and the MaxDataRate.
+ * Each controller keeps no per-flow state other than its attributes, but
+ * should be used by a single application to make the RateUpdate trace
+ * meaningful.
+ */
+class BurstRateController : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+
+    BurstRateController();
+    virtual ~BurstRateController();
+
+    /**
+     * @brief Compute the new target data rate from a reception report
+     * @param feedback the reception report sent by the BurstSink
+     * @param currentRate the current target data rate
+     * @return the new target data rate
+     */
+    DataRate Update(const BurstFeedbackHeader& feedback, DataRate currentRate);
+
+    /**
+     * TracedCallback signature for a target data rate update
+     *
+     * @param oldRate The previous target data rate
+     * @param newRate The new target data rate
+     */
+    typedef void (*RateUpdateCallback)(DataRate oldRate, DataRate newRate);
+
+  private:
+    DataRate m_minDataRate;          //!< Minimum target data rate
+    DataRate m_maxDataRate;          //!< Maximum target data rate
+    Time m_targetDelay;              //!< One-way delay above which the link is overused
+    double m_delayGradientThreshold; //!< Delay gradient above which the link is overused [s/s]
+    double m_increaseFactor;         //!< Multiplicative increase per feedback
+    double m_decreaseFactor;         //!< Multiplicative decrease of the receive rate upon overuse
+
+    /// Callback for target data rate updates
+    TracedCallback<DataRate, DataRate> m_rateUpdateTrace;
+};
+
+} // namespace ns3
+
+#endif /* BURST_RATE_CONTROLLER_H */
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-reassembly-buffer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstReassemblyBuffer");
+
+BurstReassemblyBuffer::BurstReassemblyBuffer()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BurstReassemblyBuffer::Reset(uint64_t burstSeq,
+                             uint32_t frags,
+                             uint64_t burstSize,
+                             bool storePayloads,
+                             uint32_t parity,
+                             BurstFecCodec::Scheme fecScheme)
+{
+    NS_LOG_FUNCTION(this << burstSeq << frags << burstSize << storePayloads << parity
+                         << fecScheme);
+
+    Clear();
+    m_burstSeq = burstSeq;
+    m_frags = frags;
+    m_parity = fecScheme == BurstFecCodec::None ? 0 : parity;
+    m_burstSize = burstSize;
+    m_receivedFragments = 0;
+    m_receivedDataFragments = 0;
+    m_receivedBytes = 0;
+    m_storePayloads = storePayloads;
+    m_shardSize = 0;
+
+    // resizing within the current capacity does not allocate
+    m_receivedBitmap.assign((frags + m_parity + 63) / 64, 0);
+    if (m_storePayloads)
+    {
+        m_slots.resize(frags + m_parity);
+    }
+    if (m_parity > 0)
+    {
+        m_fecCodec.Configure(fecScheme, frags, m_parity);
+        m_groupReceived.assign(m_fecCodec.GetGroups(), 0);
+        m_pendingGroups = 0;
+        for (uint32_t group = 0; group < m_fecCodec.GetGroups(); group++)
+        {
+            if (m_fecCodec.GetGroupDataShards(group) > 0)
+            {
+                m_pendingGroups++;
+            }
+        }
+    }
+}
+
+void
+BurstReassemblyBuffer::Clear()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_storePayloads)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < m_frags + m_parity; i++)
+    {
+        m_slots[i] = nullptr;
+    }
+    m_storedBytes = 0;
+}
+
+bool
+BurstReassemblyBuffer::AddFragment(uint32_t fragSeq, Ptr<Packet> payload)
+{
+    NS_LOG_FUNCTION(this << fragSeq << payload);
+    NS_ASSERT_MSG(m_storePayloads, "Fragment payloads are not being stored");
+
+    if (!MarkReceived(fragSeq, payload->GetSize()))
+    {
+        return false;
+    }
+    m_slots[fragSeq] = payload;
+    m_storedBytes += payload->GetSize();
+    return true;
+}
+
+bool
+BurstReassemblyBuffer::AddFragment(uint32_t fragSeq, uint32_t payloadSize)
+{
+    NS_LOG_FUNCTION(this << fragSeq << payloadSize);
+    NS_ASSERT_MSG(!m_storePayloads, "Fragment payloads should be stored");
+
+    return MarkReceived(fragSeq, payloadSize);
+}
+
+bool
+BurstReassemblyBuffer::MarkReceived(uint32_t fragSeq, uint32_t payloadSize)
+{
+    if (fragSeq >= m_frags + m_parity)
+    {
+        NS_LOG_WARN("Fragment seq " << fragSeq << " out of range for burst " << m_burstSeq
+                                    << " with " << m_frags << " data and " << m_parity
+                                    << " parity fragments");
+        return false;
+    }
+    if (HasFragment(fragSeq))
+    {
+        NS_LOG_LOGIC("Duplicate fragment " << fragSeq << " of burst " << m_burstSeq);
+        return false;
+    }
+
+    m_receivedBitmap[fragSeq / 64] |= (uint64_t(1) << (fragSeq % 64));
+    m_receivedFragments++;
+    if (fragSeq < m_frags)
+    {
+        m_receivedDataFragments++;
+        m_receivedBytes += payloadSize;
+    }
+    else
+    {
+        // parity fragments all have the size of the FEC shards
+        m_shardSize = payloadSize;
+    }
+
+    if (m_parity > 0)
+    {
+        uint32_t group = m_fecCodec.GetGroup(fragSeq);
+        if (++m_groupReceived[group] == m_fecCodec.GetGroupDataShards(group))
+        {
+            m_pendingGroups--;
+        }
+    }
+    return true;
+}
+
+bool
+BurstReassemblyBuffer::HasFragment(uint32_t fragSeq) const
+{
+    return fragSeq < m_frags + m_parity && (m_receivedBitmap[fragSeq / 64] >> (fragSeq % 64)) & 1;
+}
+
+bool
+BurstReassemblyBuffer::IsComplete() const
+{
+    return m_frags > 0 &&
+           (m_receivedDataFragments == m_frags || (m_parity > 0 && m_pendingGroups == 0));
+}
+
+std::vector<std::pair<uint32_t, uint32_t>>
+BurstReassemblyBuffer::GetMissingRanges(uint32_t maxRanges) const
+{
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    uint32_t fragSeq = 0;
+    while (fragSeq < m_frags && ranges.size() < maxRanges)
+    {
+        if (HasFragment(fragSeq))
+        {
+            fragSeq++;
+            continue;
+        }
+        uint32_t first = fragSeq;
+        while (fragSeq < m_frags && !HasFragment(fragSeq))
+        {
+            fragSeq++;
+        }
+        ranges.push_back(std::make_pair(first, fragSeq - first));
+    }
+    return ranges;
+}
+
+bool
+BurstReassemblyBuffer::IsStoringPayloads() const
+{
+    return m_storePayloads;
+}
+
+Ptr<Packet>
+BurstReassemblyBuffer::AssembleBurst()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_storePayloads, "Fragment payloads were not stored");
+    NS_ASSERT_MSG(IsComplete(),
+                  "Burst " << m_burstSeq << " incomplete: " << m_receivedDataFragments << "/"
+                           << m_frags << " data fragments received");
+
+    if (m_receivedDataFragments < m_frags)
+    {
+        return DecodeBurst();
+    }
+
+    // fragments are appended in order, once per burst: payloads without data, as those of
+    // simulated bursts, only extend the zero area of the burst, and are never materialized
+    Ptr<Packet> burst = m_slots[0]->Copy();
+    for (uint32_t i = 1; i < m_frags; i++)
+    {
+        burst->AddAtEnd(m_slots[i]);
+    }
+    NS_ASSERT_MSG(burst->GetSize() == m_burstSize, burst->GetSize() << " == " << m_burstSize);
+
+    Clear();
+    return burst;
+}
+
+Ptr<Packet>
+BurstReassemblyBuffer::DecodeBurst()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_shardSize > 0);
+
+    // data fragments are filled in order: fragment i carries the payload bytes from
+    // i * shardSize, the burst being the concatenation of the zero-padded data shards
+    std::vector<uint8_t> data(size_t(m_frags) * m_shardSize, 0);
+    std::vector<uint8_t> parity(size_t(m_parity) * m_shardSize, 0);
+    std::vector<bool> received(m_frags + m_parity, false);
+    for (uint32_t i = 0; i < m_frags + m_parity; i++)
+    {
+        if (!HasFragment(i))
+        {
+            continue;
+        }
+        received[i] = true;
+        NS_ABORT_MSG_IF(m_slots[i]->GetSize() > m_shardSize,
+                        "Fragment " << i << " of " << m_slots[i]->GetSize()
+                                    << " B larger than the FEC shard size " << m_shardSize);
+        uint8_t* shard = i < m_frags ? data.data() + size_t(i) * m_shardSize
+                                     : parity.data() + size_t(i - m_frags) * m_shardSize;
+        m_slots[i]->CopyData(shard, m_slots[i]->GetSize());
+    }
+
+    bool decoded = m_fecCodec.Decode(data.data(), parity.data(), received, m_shardSize);
+    NS_ABORT_MSG_IF(!decoded, "Unable to recover burst " << m_burstSeq);
+    NS_ABORT_MSG_IF(data.size() < m_burstSize,
+                    "FEC shards of " << data.size() << " B cannot hold burst of " << m_burstSize
+                                     << " B");
+    NS_LOG_LOGIC("Recovered " << m_frags - m_receivedDataFragments << " data fragments of burst "
+                              << m_burstSeq);
+
+    Clear();
+    return Create<Packet>(data.data(), m_burstSize);
+}
+
+uint64_t
+BurstReassemblyBuffer::GetBurstSeq() const
+{
+    return m_burstSeq;
+}
+
+uint32_t
+BurstReassemblyBuffer::GetFrags() const
+{
+    return m_frags;
+}
+
+uint32_t
+BurstReassemblyBuffer::GetParity() const
+{
+    return m_parity;
+}
+
+uint64_t
+BurstReassemblyBuffer::GetBurstSize() const
+{
+    return m_burstSize;
+}
+
+uint32_t
+BurstReassemblyBuffer::GetReceivedFragments() const
+{
+    return m_receivedFragments;
+}
+
+uint32_t
+BurstReassemblyBuffer::GetReceivedDataFragments() const
+{
+    return m_receivedDataFragments;
+}
+
+uint64_t
+BurstReassemblyBuffer::GetReceivedBytes() const
+{
+    return m_receivedBytes;
+}
+
+uint64_t
+BurstReassemblyBuffer::GetMemoryUsage() const
+{
+    return m_receivedBitmap.capacity() * sizeof(uint64_t) +
+           m_slots.capacity() * sizeof(Ptr<Packet>) +
+           m_groupReceived.capacity() * sizeof(uint32_t) + m_storedBytes;
+}
+
+} // namespace ns3
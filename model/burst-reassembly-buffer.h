@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_REASSEMBLY_BUFFER_H
+#define BURST_REASSEMBLY_BUFFER_H
+
+#include "burst-fec-codec.h"
+
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup burstsink
+ *
+ * @brief Reassembly buffer for the fragments of a single burst
+ *
+ * The buffer is sized from the number of fragments announced by the
+ * SeqTsSizeFragHeader of the burst: a bitmap keeps track of the received
+ * fragments, and a preallocated array of slots holds the fragment payloads
+ * in order, regardless of their arrival order.
+ * The burst is assembled only once, when all fragments have been received.
+ *
+ * The buffer is meant to be reused across bursts: Reset keeps the storage
+ * already allocated, so that a flow in steady state does not need further
+ * heap allocations.
+ *
+ * If the burst is protected by forward error correction, parity fragments
+ * are stored in the slots following the data fragments, and the burst is
+ * complete as soon as each FEC group received as many fragments as its data
+ * fragments. Missing data fragments are then recovered by the BurstFecCodec
+ * when the burst is assembled.
+ *
+ * If the burst does not need to be materialized, the buffer can be reset
+ * to only account for the received fragments and bytes, without storing
+ * the fragment payloads.
+ */
+class BurstReassemblyBuffer
+{
+  public:
+    BurstReassemblyBuffer();
+
+    /**
+     * @brief Prepare the buffer to reassemble a new burst
+     * @param burstSeq the sequence number of the burst
+     * @param frags the total number of data fragments of the burst
+     * @param burstSize the total size of the burst payload [B]
+     * @param storePayloads whether fragment payloads should be stored to
+     * assemble the burst, or only accounted for
+     * @param parity the number of parity fragments of the burst
+     * @param fecScheme the FEC scheme used for the parity fragments
+     */
+    void Reset(uint64_t burstSeq,
+               uint32_t frags,
+               uint64_t burstSize,
+               bool storePayloads = true,
+               uint32_t parity = 0,
+               BurstFecCodec::Scheme fecScheme = BurstFecCodec::None);
+
+    /**
+     * @brief Release the stored fragments, keeping the allocated storage.
+     * Counters are left untouched.
+     */
+    void Clear();
+
+    /**
+     * @brief Store a fragment payload
+     * @param fragSeq the sequence number of the fragment within the burst
+     * @param payload the fragment payload, without header
+     * @return false if the fragment is a duplicate or out of range, true otherwise
+     */
+    bool AddFragment(uint32_t fragSeq, Ptr<Packet> payload);
+
+    /**
+     * @brief Account for a fragment without storing its payload.
+     * Can only be used if the buffer is not storing fragment payloads.
+     * @param fragSeq the sequence number of the fragment within the burst
+     * @param payloadSize the size of the fragment payload [B]
+     * @return false if the fragment is a duplicate or out of range, true otherwise
+     */
+    bool AddFragment(uint32_t fragSeq, uint32_t payloadSize);
+
+    /**
+     * @brief Check whether a fragment has already been received
+     * @param fragSeq the sequence number of the fragment within the burst
+     * @return true if the fragment has been received
+     */
+    bool HasFragment(uint32_t fragSeq) const;
+
+    /**
+     * @return true if all data fragments of the burst have been received,
+     * or if the missing ones can be recovered from the parity fragments
+     */
+    bool IsComplete() const;
+
+    /**
+     * @brief Get the missing data fragments, as ranges of consecutive fragments
+     * @param maxRanges the maximum number of ranges to return
+     * @return the missing ranges, as pairs of first fragment sequence number and
+     * number of fragments, in increasing order
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> GetMissingRanges(uint32_t maxRanges) const;
+
+    /**
+     * @return true if fragment payloads are stored and the burst can be assembled
+     */
+    bool IsStoringPayloads() const;
+
+    /**
+     * @brief Assemble the burst, concatenating the fragment payloads in order.
+     * Missing data fragments are recovered from the parity fragments.
+     * The stored fragments are released.
+     * Can only be called if the buffer is storing fragment payloads.
+     * @return the reassembled burst
+     */
+    Ptr<Packet> AssembleBurst();
+
+    /**
+     * @return the sequence number of the burst
+     */
+    uint64_t GetBurstSeq() const;
+
+    /**
+     * @return the total number of data fragments of the burst
+     */
+    uint32_t GetFrags() const;
+
+    /**
+     * @return the number of parity fragments of the burst
+     */
+    uint32_t GetParity() const;
+
+    /**
+     * @return the total size of the burst payload [B]
+     */
+    uint64_t GetBurstSize() const;
+
+    /**
+     * @return the number of fragments received so far, parity fragments included
+     */
+    uint32_t GetReceivedFragments() const;
+
+    /**
+     * @return the number of data fragments received so far
+     */
+    uint32_t GetReceivedDataFragments() const;
+
+    /**
+     * @return the number of data payload bytes received so far
+     */
+    uint64_t GetReceivedBytes() const;
+
+    /**
+     * @return the memory held by the buffer [B], i.e., the storage allocated for the
+     * bookkeeping of the fragments and the payloads of the fragments currently stored
+     */
+    uint64_t GetMemoryUsage() const;
+
+  private:
+    /**
+     * @brief Mark a fragment as received
+     * @param fragSeq the sequence number of the fragment within the burst
+     * @param payloadSize the size of the fragment payload [B]
+     * @return false if the fragment is a duplicate or out of range, true otherwise
+     */
+    bool MarkReceived(uint32_t fragSeq, uint32_t payloadSize);
+
+    /**
+     * @brief Recover the missing data fragments and assemble the burst
+     * @return the reassembled burst
+     */
+    Ptr<Packet> DecodeBurst();
+
+    uint64_t m_burstSeq{0};                 //!< Sequence number of the burst
+    uint32_t m_frags{0};                    //!< Total number of data fragments of the burst
+    uint32_t m_parity{0};                   //!< Number of parity fragments of the burst
+    uint64_t m_burstSize{0};                //!< Total size of the burst payload [B]
+    uint32_t m_receivedFragments{0};        //!< Number of fragments received
+    uint32_t m_receivedDataFragments{0};    //!< Number of data fragments received
+    uint64_t m_receivedBytes{0};            //!< Number of data payload bytes received
+    bool m_storePayloads{true};             //!< Whether fragment payloads are stored
+    std::vector<uint64_t> m_receivedBitmap; //!< One bit per fragment, set when received
+    std::vector<Ptr<Packet>> m_slots;       //!< Fragment payloads, indexed by fragment sequence
+    BurstFecCodec m_fecCodec;               //!< FEC decoder
+    std::vector<uint32_t> m_groupReceived;  //!< Fragments received per FEC group
+    uint32_t m_pendingGroups{0};            //!< FEC groups which cannot be recovered yet
+    uint32_t m_shardSize{0};                //!< Size of the parity fragment payloads [B]
+    uint64_t m_storedBytes{0};              //!< Size of the fragment payloads stored [B]
+};
+
+} // namespace ns3
+
+#endif /* BURST_REASSEMBLY_BUFFER_H */
@@ -9,11 +9,13 @@
  */
 #include "burst-sink.h"
 
+#include "compact-frag-header.h"
+
 #include "ns3/address-utils.h"
 #include "ns3/address.h"
 #include "ns3/boolean.h"
-#include "ns3/inet-socket-address.h"
-#include "ns3/inet6-socket-address.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
@@ -23,6 +25,10 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/udp-socket.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
 
 namespace ns3
 {
@@ -48,6 +54,94 @@ BurstSink::GetTypeId(void)
                                           TypeIdValue(UdpSocketFactory::GetTypeId()),
                                           MakeTypeIdAccessor(&BurstSink::m_tid),
                                           MakeTypeIdChecker())
+                            .AddAttribute("ReassemblyWindow",
+                                          "The number of bursts per flow that are reassembled "
+                                          "concurrently. Incomplete bursts are discarded only "
+                                          "once they fall off the window.",
+                                          UintegerValue(1),
+                                          MakeUintegerAccessor(&BurstSink::m_reassemblyWindow),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("ReassemblyMode",
+                                          "How received bursts are reassembled: Auto "
+                                          "materializes bursts only if some callback is "
+                                          "connected to the BurstRx trace, Materialize always "
+                                          "merges the fragment payloads into the burst, "
+                                          "ByteAccounting only accounts for received fragments "
+                                          "and bytes.",
+                                          EnumValue(ReassemblyMode::Auto),
+                                          MakeEnumAccessor<ReassemblyMode>(
+                                              &BurstSink::m_reassemblyMode),
+                                          MakeEnumChecker(ReassemblyMode::Auto,
+                                                          "Auto",
+                                                          ReassemblyMode::Materialize,
+                                                          "Materialize",
+                                                          ReassemblyMode::ByteAccounting,
+                                                          "ByteAccounting"))
+                            .AddAttribute("ReassemblyTimeout",
+                                          "If strictly positive, a burst not completed within "
+                                          "this time since the reception of its first fragment "
+                                          "is discarded.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&BurstSink::m_reassemblyTimeout),
+                                          MakeTimeChecker(Seconds(0)))
+                            .AddAttribute("NackInterval",
+                                          "If strictly positive, a NACK listing the missing "
+                                          "fragments of an incomplete burst is sent back to its "
+                                          "source after this time without receiving fragments "
+                                          "of the burst, and repeated at this interval.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&BurstSink::m_nackInterval),
+                                          MakeTimeChecker(Seconds(0)))
+                            .AddAttribute("MaxNackRounds",
+                                          "The maximum number of NACKs sent for each burst.",
+                                          UintegerValue(3),
+                                          MakeUintegerAccessor(&BurstSink::m_maxNackRounds),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("FeedbackInterval",
+                                          "If strictly positive, a reception report is sent "
+                                          "back to the source of each flow at this interval.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&BurstSink::m_feedbackInterval),
+                                          MakeTimeChecker(Seconds(0)))
+                            .AddAttribute("MaxFlows",
+                                          "If strictly positive, the maximum number of flows "
+                                          "in the flow table: the least recently active flow "
+                                          "is evicted to make room for a new one.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&BurstSink::m_maxFlows),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("FlowIdleTimeout",
+                                          "If strictly positive, a flow receiving no fragment "
+                                          "for this time is evicted from the flow table.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&BurstSink::m_flowIdleTimeout),
+                                          MakeTimeChecker(Seconds(0)))
+                            .AddAttribute("HeaderFormat",
+                                          "The serialization format of the fragment headers, "
+                                          "either the fixed-size SeqTsSizeFragHeader or the "
+                                          "variable-length CompactFragHeader. Must match the "
+                                          "one of the BurstyApplication.",
+                                          EnumValue(SeqTsSizeFragHeader::Full),
+                                          MakeEnumAccessor<SeqTsSizeFragHeader::Format>(
+                                              &BurstSink::m_headerFormat),
+                                          MakeEnumChecker(SeqTsSizeFragHeader::Full,
+                                                          "Full",
+                                                          SeqTsSizeFragHeader::Compact,
+                                                          "Compact"))
+                            .AddAttribute("PlayoutDelay",
+                                          "If strictly positive, received bursts go through a "
+                                          "playout stage displaying each frame at the first "
+                                          "vsync at least this delay after its generation.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&BurstSink::m_playoutDelay),
+                                          MakeTimeChecker(Seconds(0)))
+                            .AddAttribute("PlayoutFrameRate",
+                                          "The rate of the vsync clock of the playout stage "
+                                          "[FPS], which should match the frame rate of the "
+                                          "stream.",
+                                          DoubleValue(60),
+                                          MakeDoubleAccessor(&BurstSink::m_playoutFrameRate),
+                                          MakeDoubleChecker<double>(0))
                             .AddTraceSource("FragmentRx",
                                             "A fragment has been received",
                                             MakeTraceSourceAccessor(&BurstSink::m_rxFragmentTrace),
@@ -55,7 +149,51 @@ BurstSink::GetTypeId(void)
                             .AddTraceSource("BurstRx",
                                             "A burst has been successfully received",
                                             MakeTraceSourceAccessor(&BurstSink::m_rxBurstTrace),
-                                            "ns3::BurstSink::SeqTsSizeFragCallback");
+                                            "ns3::BurstSink::SeqTsSizeFragCallback")
+                            .AddTraceSource(
+                                "BurstPartialRx",
+                                "An incomplete burst has been discarded, either because its "
+                                "reassembly timeout expired or because it fell off the "
+                                "reassembly window",
+                                MakeTraceSourceAccessor(&BurstSink::m_rxPartialBurstTrace),
+                                "ns3::BurstSink::PartialBurstCallback")
+                            .AddTraceSource("NackTx",
+                                            "A NACK has been sent back to the source of a burst",
+                                            MakeTraceSourceAccessor(&BurstSink::m_txNackTrace),
+                                            "ns3::BurstSink::NackCallback")
+                            .AddTraceSource(
+                                "BurstRecovered",
+                                "A burst has been received after sending NACKs for its missing "
+                                "fragments",
+                                MakeTraceSourceAccessor(&BurstSink::m_recoveredBurstTrace),
+                                "ns3::BurstSink::RecoveredBurstCallback")
+                            .AddTraceSource("FeedbackTx",
+                                            "A reception report has been sent back to the "
+                                            "source of a flow",
+                                            MakeTraceSourceAccessor(&BurstSink::m_txFeedbackTrace),
+                                            "ns3::BurstSink::FeedbackCallback")
+                            .AddTraceSource("FlowEvicted",
+                                            "A flow has been evicted from the flow table",
+                                            MakeTraceSourceAccessor(&BurstSink::m_flowEvictedTrace),
+                                            "ns3::BurstSink::FlowEvictedCallback")
+                            .AddTraceSource(
+                                "FrameDisplayed",
+                                "A frame has been displayed by the playout stage, either at its "
+                                "target vsync or late",
+                                MakeTraceSourceAccessor(&BurstSink::m_frameDisplayedTrace),
+                                "ns3::BurstSink::FrameDisplayedCallback")
+                            .AddTraceSource(
+                                "FrameSkipped",
+                                "A received frame has been skipped by the playout stage, since "
+                                "a more recent frame was displayed first",
+                                MakeTraceSourceAccessor(&BurstSink::m_frameSkippedTrace),
+                                "ns3::BurstSink::FrameSkippedCallback")
+                            .AddTraceSource(
+                                "PlayoutStall",
+                                "A frame has been displayed after one or more vsyncs without a "
+                                "new frame",
+                                MakeTraceSourceAccessor(&BurstSink::m_playoutStallTrace),
+                                "ns3::BurstSink::PlayoutStallCallback");
     return tid;
 }
 
@@ -90,6 +228,79 @@ BurstSink::GetTotalRxBursts() const
     return m_totRxBursts;
 }
 
+uint64_t
+BurstSink::GetTotalFecRecoveredBursts() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totFecRecoveredBursts;
+}
+
+uint64_t
+BurstSink::GetTotalEvictedFlows() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totEvictedFlows;
+}
+
+uint64_t
+BurstSink::GetTotalDisplayedFrames() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totDisplayedFrames;
+}
+
+uint64_t
+BurstSink::GetTotalLateFrames() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totLateFrames;
+}
+
+uint64_t
+BurstSink::GetTotalSkippedFrames() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totSkippedFrames;
+}
+
+uint64_t
+BurstSink::GetTotalPlayoutStalls() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_totPlayoutStalls;
+}
+
+uint32_t
+BurstSink::GetActiveFlows() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_flowHandlerMap.size();
+}
+
+uint64_t
+BurstSink::GetFlowTableMemory() const
+{
+    NS_LOG_FUNCTION(this);
+
+    uint64_t memory = 0;
+    for (const auto& flow : m_flowHandlerMap)
+    {
+        memory += sizeof(flow) + sizeof(FlowKey) +
+                  flow.second.m_bursts.capacity() * sizeof(BurstHandler);
+        for (const auto& burstHandler : flow.second.m_bursts)
+        {
+            memory += burstHandler.m_buffer.GetMemoryUsage();
+            for (const auto& early : burstHandler.m_earlyFragments)
+            {
+                memory += sizeof(early) + early.second->GetSize();
+            }
+        }
+        memory += flow.second.m_playout.m_frames.size() *
+                  sizeof(std::map<uint64_t, PlayoutFrame>::value_type);
+    }
+    return memory;
+}
+
 Ptr<Socket>
 BurstSink::GetListeningSocket(void) const
 {
@@ -110,6 +321,9 @@ BurstSink::DoDispose(void)
     NS_LOG_FUNCTION(this);
     m_socket = 0;
     m_socketList.clear();
+    m_deframers.clear();
+    m_flowHandlerMap.clear();
+    m_flowLru.clear();
 
     // chain up
     Application::DoDispose();
@@ -120,6 +334,8 @@ void
 BurstSink::StartApplication() // Called at time specified by Start
 {
     NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_playoutDelay.IsStrictlyPositive() && m_playoutFrameRate <= 0,
+                    "The playout stage requires a positive PlayoutFrameRate");
     // Create the socket if not already
     if (!m_socket)
     {
@@ -129,7 +345,11 @@ BurstSink::StartApplication() // Called at time specified by Start
             NS_FATAL_ERROR("Failed to bind socket");
         }
         m_socket->Listen();
-        m_socket->ShutdownSend();
+        if (!m_nackInterval.IsStrictlyPositive() && !m_feedbackInterval.IsStrictlyPositive())
+        {
+            // NACKs and reception reports are sent back on the same flow
+            m_socket->ShutdownSend();
+        }
         if (addressUtils::IsMulticast(m_local))
         {
             Ptr<UdpSocket> udpSocket = DynamicCast<UdpSocket>(m_socket);
@@ -150,6 +370,12 @@ BurstSink::StartApplication() // Called at time specified by Start
                                 MakeCallback(&BurstSink::HandleAccept, this));
     m_socket->SetCloseCallbacks(MakeCallback(&BurstSink::HandlePeerClose, this),
                                 MakeCallback(&BurstSink::HandlePeerError, this));
+
+    if (m_feedbackInterval.IsStrictlyPositive())
+    {
+        m_feedbackEvent.Cancel();
+        m_feedbackEvent = Simulator::Schedule(m_feedbackInterval, &BurstSink::SendFeedback, this);
+    }
 }
 
 void
@@ -162,180 +388,862 @@ BurstSink::StopApplication() // Called at time specified by Stop
         m_socketList.pop_front();
         acceptedSocket->Close();
     }
+    m_deframers.clear();
     if (m_socket)
     {
         m_socket->Close();
         m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
     }
+    for (auto& flow : m_flowHandlerMap)
+    {
+        flow.second.m_timeoutEvent.Cancel();
+        flow.second.m_nackEvent.Cancel();
+        flow.second.m_playout.m_vsyncEvent.Cancel();
+    }
+    m_feedbackEvent.Cancel();
+    m_idleEvictionEvent.Cancel();
 }
 
 void
 BurstSink::HandleRead(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
-    Ptr<Packet> fragment;
+    Ptr<Packet> packet;
     Address from;
     Address localAddress;
-    while ((fragment = socket->RecvFrom(from)))
+    socket->GetSockName(localAddress);
+    bool stream = socket->GetSocketType() == Socket::NS3_SOCK_STREAM;
+    while ((packet = socket->RecvFrom(from)))
     {
-        if (fragment->GetSize() == 0)
+        if (packet->GetSize() == 0)
         { // EOF
             break;
         }
-        m_totRxBytes += fragment->GetSize();
+        m_totRxBytes += packet->GetSize();
 
-        std::stringstream addressStr;
-        if (InetSocketAddress::IsMatchingType(from))
+        if (!stream)
         {
-            addressStr << InetSocketAddress::ConvertFrom(from).GetIpv4() << " port "
-                       << InetSocketAddress::ConvertFrom(from).GetPort();
+            // each datagram is a fragment
+            HandleFragment(socket, packet, from, localAddress);
+            continue;
         }
-        else if (Inet6SocketAddress::IsMatchingType(from))
+
+        // a read from a byte stream may carry part of a fragment, or several fragments
+        BurstStreamDeframer& deframer = m_deframers[socket];
+        deframer.Push(packet);
+        Ptr<Packet> fragment;
+        while ((fragment = deframer.Pop()))
         {
-            addressStr << Inet6SocketAddress::ConvertFrom(from).GetIpv6() << " port "
-                       << Inet6SocketAddress::ConvertFrom(from).GetPort();
+            HandleFragment(socket, fragment, from, localAddress);
         }
-        else
+    }
+}
+
+void
+BurstSink::HandleFragment(Ptr<Socket> socket,
+                          Ptr<Packet> fragment,
+                          const Address& from,
+                          const Address& localAddress)
+{
+    NS_LOG_FUNCTION(this << socket << fragment << from);
+
+    // the source is only formatted if logging is enabled
+    FlowKey key(from);
+    NS_LOG_INFO("At time " << Simulator::Now().As(Time::S) << " burst sink received "
+                           << fragment->GetSize() << " bytes from " << key << " total Rx "
+                           << m_totRxBytes << " bytes");
+
+    // handle received fragment
+    auto itFlow = m_flowHandlerMap.find(key);
+    if (itFlow == m_flowHandlerMap.end())
+    {
+        NS_LOG_LOGIC("New stream from " << key);
+        if (m_maxFlows > 0 && m_flowHandlerMap.size() >= m_maxFlows)
+        {
+            // make room evicting the least recently active flow
+            EvictFlow(m_flowHandlerMap.find(m_flowLru.back()));
+        }
+        itFlow = m_flowHandlerMap.insert(std::make_pair(key, FlowHandler())).first;
+        itFlow->second.m_bursts.resize(m_reassemblyWindow);
+        itFlow->second.m_peerAddress = from;
+        m_flowLru.push_front(key);
+        itFlow->second.m_lruIt = m_flowLru.begin();
+    }
+    else if (itFlow->second.m_lruIt != m_flowLru.begin())
+    {
+        // move the flow to the front of the LRU list, without reallocating
+        m_flowLru.splice(m_flowLru.begin(), m_flowLru, itFlow->second.m_lruIt);
+    }
+    itFlow->second.m_lastRxTime = Simulator::Now();
+    ScheduleIdleEviction();
+    itFlow->second.m_localAddress = localAddress;
+    itFlow->second.m_socket = socket;
+    FragmentReceived(itFlow->second, fragment, from, localAddress);
+}
+
+void
+BurstSink::ResetBurstHandler(FlowHandler& flowHandler,
+                             BurstHandler& burstHandler,
+                             const SeqTsSizeFragHeader& header,
+                             bool hasMetadata,
+                             const Address& from)
+{
+    NS_LOG_FUNCTION(this << header << hasMetadata << from);
+
+    if (burstHandler.m_active && !burstHandler.m_complete && !burstHandler.m_timedOut)
+    {
+        NS_LOG_LOGIC("Burst seq " << burstHandler.m_buffer.GetBurstSeq()
+                                  << " fell off the reassembly window");
+        DiscardIncompleteBurst(flowHandler, burstHandler, from);
+    }
+
+    bool materialize = m_reassemblyMode == ReassemblyMode::Materialize ||
+                       (m_reassemblyMode == ReassemblyMode::Auto && !m_rxBurstTrace.IsEmpty());
+    if (header.GetSize() > std::numeric_limits<uint32_t>::max())
+    {
+        // packets are limited to 4 GB
+        NS_LOG_LOGIC("Burst seq " << header.GetSeq() << " of " << header.GetSize()
+                                  << " B is too large to be materialized");
+        materialize = false;
+    }
+
+    burstHandler.m_active = true;
+    burstHandler.m_complete = false;
+    burstHandler.m_timedOut = false;
+    burstHandler.m_header = header;
+    burstHandler.m_deadline = Simulator::Now() + m_reassemblyTimeout;
+    burstHandler.m_nackTime = Simulator::Now() + m_nackInterval;
+    burstHandler.m_nackRounds = 0;
+    burstHandler.m_hasMetadata = hasMetadata;
+    burstHandler.m_earlyFragments.clear();
+    if (!hasMetadata)
+    {
+        // the number of fragments is unknown until the metadata of the burst arrives
+        burstHandler.m_buffer.Reset(header.GetSeq(), 0, 0, materialize);
+        return;
+    }
+    burstHandler.m_buffer.Reset(header.GetSeq(),
+                                header.GetFrags(),
+                                header.GetSize(),
+                                materialize,
+                                header.GetParity(),
+                                BurstFecCodec::Scheme(header.GetFecScheme()));
+}
+
+void
+BurstSink::DiscardIncompleteBurst(FlowHandler& flowHandler,
+                                  BurstHandler& burstHandler,
+                                  const Address& from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    const BurstReassemblyBuffer& buffer = burstHandler.m_buffer;
+    // nothing is known to be received of a burst whose metadata never arrived
+    double fragmentFraction =
+        buffer.GetFrags() > 0 ? double(buffer.GetReceivedDataFragments()) / buffer.GetFrags() : 0;
+    double byteFraction =
+        buffer.GetBurstSize() > 0 ? double(buffer.GetReceivedBytes()) / buffer.GetBurstSize() : 0;
+    NS_LOG_LOGIC("Discarding incomplete burst seq "
+                 << buffer.GetBurstSeq() << ": received " << buffer.GetReceivedDataFragments()
+                 << "/" << buffer.GetFrags() << " data fragments, "
+                 << buffer.GetReceivedBytes() << "/" << buffer.GetBurstSize() << " B");
+
+    burstHandler.m_timedOut = true;
+    burstHandler.m_buffer.Clear();
+    burstHandler.m_earlyFragments.clear();
+    flowHandler.m_feedback.m_lostBursts++;
+    m_rxPartialBurstTrace(from,
+                          flowHandler.m_localAddress,
+                          burstHandler.m_header,
+                          fragmentFraction,
+                          byteFraction);
+}
+
+void
+BurstSink::CountMissingBursts(FlowHandler& flowHandler, uint64_t highestBurstSeq)
+{
+    NS_LOG_FUNCTION(this << highestBurstSeq);
+
+    uint64_t window = flowHandler.m_bursts.size();
+    uint64_t oldHighestSeq = flowHandler.m_highestBurstSeq;
+    if (highestBurstSeq < window)
+    {
+        return;
+    }
+
+    // bursts up to lastSeq fall off the window, those up to the previous highest one might have
+    // a handler, while the newer ones were never received
+    uint64_t firstSeq = oldHighestSeq + 1 >= window ? oldHighestSeq + 1 - window : 0;
+    firstSeq = std::max(firstSeq, flowHandler.m_firstBurstSeq);
+    uint64_t lastSeq = highestBurstSeq - window;
+    uint64_t missing = 0;
+    for (uint64_t seq = firstSeq; seq <= std::min(lastSeq, oldHighestSeq); seq++)
+    {
+        const BurstHandler& burstHandler = flowHandler.m_bursts[seq % window];
+        if (!burstHandler.m_active || burstHandler.m_header.GetSeq() != seq)
+        {
+            missing++;
+        }
+    }
+    if (lastSeq > oldHighestSeq)
+    {
+        missing += lastSeq - oldHighestSeq;
+    }
+
+    if (missing > 0)
+    {
+        NS_LOG_LOGIC(missing << " bursts fell off the reassembly window without any fragment "
+                             << "received");
+        flowHandler.m_feedback.m_lostBursts += missing;
+    }
+}
+
+void
+BurstSink::ScheduleReassemblyTimeout(FlowHandler& flowHandler, const Address& from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    if (!m_reassemblyTimeout.IsStrictlyPositive())
+    {
+        return;
+    }
+
+    // find the earliest deadline among the incomplete bursts
+    bool found = false;
+    Time earliestDeadline;
+    for (const auto& burstHandler : flowHandler.m_bursts)
+    {
+        if (burstHandler.m_active && !burstHandler.m_complete && !burstHandler.m_timedOut &&
+            (!found || burstHandler.m_deadline < earliestDeadline))
+        {
+            found = true;
+            earliestDeadline = burstHandler.m_deadline;
+        }
+    }
+
+    if (!found)
+    {
+        flowHandler.m_timeoutEvent.Cancel();
+        return;
+    }
+    if (!flowHandler.m_timeoutEvent.IsExpired() &&
+        Simulator::GetDelayLeft(flowHandler.m_timeoutEvent) + Simulator::Now() == earliestDeadline)
+    {
+        // timer already set to the earliest deadline
+        return;
+    }
+
+    flowHandler.m_timeoutEvent.Cancel();
+    flowHandler.m_timeoutEvent = Simulator::Schedule(earliestDeadline - Simulator::Now(),
+                                                     &BurstSink::ReassemblyTimeoutExpired,
+                                                     this,
+                                                     from);
+}
+
+void
+BurstSink::ReassemblyTimeoutExpired(Address from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    auto itFlow = m_flowHandlerMap.find(FlowKey(from));
+    if (itFlow == m_flowHandlerMap.end())
+    {
+        return;
+    }
+
+    FlowHandler& flowHandler = itFlow->second;
+    for (auto& burstHandler : flowHandler.m_bursts)
+    {
+        if (burstHandler.m_active && !burstHandler.m_complete && !burstHandler.m_timedOut &&
+            burstHandler.m_deadline <= Simulator::Now())
+        {
+            NS_LOG_LOGIC("Reassembly timeout expired for burst seq "
+                         << burstHandler.m_buffer.GetBurstSeq());
+            DiscardIncompleteBurst(flowHandler, burstHandler, from);
+        }
+    }
+
+    ScheduleReassemblyTimeout(flowHandler, from);
+}
+
+void
+BurstSink::ScheduleNack(FlowHandler& flowHandler, const Address& from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    if (!m_nackInterval.IsStrictlyPositive() || !flowHandler.m_nackEvent.IsExpired())
+    {
+        // NACKs are only postponed by new fragments: a pending timer is never late
+        return;
+    }
+
+    // find the earliest NACK due among the incomplete bursts
+    bool found = false;
+    Time earliestNack;
+    for (const auto& burstHandler : flowHandler.m_bursts)
+    {
+        if (burstHandler.m_active && !burstHandler.m_complete && !burstHandler.m_timedOut &&
+            burstHandler.m_nackRounds < m_maxNackRounds &&
+            (!found || burstHandler.m_nackTime < earliestNack))
         {
-            addressStr << "UNKNOWN ADDRESS TYPE";
+            found = true;
+            earliestNack = burstHandler.m_nackTime;
         }
+    }
 
-        NS_LOG_INFO("At time " << Simulator::Now().As(Time::S) << " burst sink received "
-                               << fragment->GetSize() << " bytes from " << addressStr.str()
-                               << " total Rx " << m_totRxBytes << " bytes");
+    if (found)
+    {
+        flowHandler.m_nackEvent = Simulator::Schedule(earliestNack - Simulator::Now(),
+                                                      &BurstSink::NackTimerExpired,
+                                                      this,
+                                                      from);
+    }
+}
 
-        socket->GetSockName(localAddress);
+void
+BurstSink::NackTimerExpired(Address from)
+{
+    NS_LOG_FUNCTION(this << from);
 
-        // handle received fragment
-        auto itBuffer = m_burstHandlerMap.find(from); // rename m_burstBufferMap, itBuffer
-        if (itBuffer == m_burstHandlerMap.end())
+    auto itFlow = m_flowHandlerMap.find(FlowKey(from));
+    if (itFlow == m_flowHandlerMap.end())
+    {
+        return;
+    }
+
+    FlowHandler& flowHandler = itFlow->second;
+    for (auto& burstHandler : flowHandler.m_bursts)
+    {
+        if (burstHandler.m_active && !burstHandler.m_complete && !burstHandler.m_timedOut &&
+            burstHandler.m_nackRounds < m_maxNackRounds &&
+            burstHandler.m_nackTime <= Simulator::Now())
         {
-            NS_LOG_LOGIC("New stream from " << from);
-            itBuffer = m_burstHandlerMap.insert(std::make_pair(from, BurstHandler())).first;
+            SendNack(flowHandler, burstHandler, from);
         }
-        FragmentReceived(itBuffer->second, fragment, from, localAddress);
     }
+
+    ScheduleNack(flowHandler, from);
 }
 
 void
-BurstSink::FragmentReceived(BurstHandler& burstHandler,
+BurstSink::SendNack(FlowHandler& flowHandler, BurstHandler& burstHandler, const Address& from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    // bound the size of the NACK: further missing fragments are requested by the next NACK
+    const uint32_t maxRanges = 256;
+
+    BurstNackHeader nack;
+    nack.SetBurstSeq(burstHandler.m_buffer.GetBurstSeq());
+    if (!burstHandler.m_hasMetadata)
+    {
+        // fragment 0 carries the metadata needed to tell which fragments are missing
+        nack.AddRange(0, 1);
+    }
+    for (const auto& range : burstHandler.m_buffer.GetMissingRanges(maxRanges))
+    {
+        nack.AddRange(range.first, range.second);
+    }
+
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(nack);
+    packet->AddHeader(BurstControlHeader(BurstControlHeader::Nack));
+    if (flowHandler.m_socket->GetSocketType() == Socket::NS3_SOCK_STREAM)
+    {
+        // length-prefixed as the fragments, to be split back from the byte stream
+        packet->AddHeader(BurstStreamHeader(packet->GetSize()));
+    }
+    if (flowHandler.m_socket->SendTo(packet, 0, from) < 0)
+    {
+        NS_LOG_WARN("Unable to send NACK " << nack << " to " << from);
+    }
+    NS_LOG_LOGIC("Sent NACK " << nack << " to " << from);
+
+    if (burstHandler.m_nackRounds == 0)
+    {
+        burstHandler.m_firstNackTime = Simulator::Now();
+    }
+    burstHandler.m_nackRounds++;
+    burstHandler.m_nackTime = Simulator::Now() + m_nackInterval;
+    m_txNackTrace(from, nack);
+}
+
+void
+BurstSink::EvictFlow(FlowTable::iterator itFlow)
+{
+    NS_ASSERT(itFlow != m_flowHandlerMap.end());
+    FlowHandler& flowHandler = itFlow->second;
+    NS_LOG_FUNCTION(this << itFlow->first);
+
+    for (auto& burstHandler : flowHandler.m_bursts)
+    {
+        if (burstHandler.m_active && !burstHandler.m_complete && !burstHandler.m_timedOut)
+        {
+            DiscardIncompleteBurst(flowHandler, burstHandler, flowHandler.m_peerAddress);
+        }
+    }
+    flowHandler.m_timeoutEvent.Cancel();
+    flowHandler.m_nackEvent.Cancel();
+    flowHandler.m_playout.m_vsyncEvent.Cancel();
+
+    Address from = flowHandler.m_peerAddress;
+    Time idleTime = Simulator::Now() - flowHandler.m_lastRxTime;
+    NS_LOG_LOGIC("Evicting flow " << itFlow->first << " idle for " << idleTime.As(Time::S));
+    m_flowLru.erase(flowHandler.m_lruIt);
+    m_flowHandlerMap.erase(itFlow);
+    m_totEvictedFlows++;
+    m_flowEvictedTrace(from, idleTime);
+}
+
+void
+BurstSink::ScheduleIdleEviction(void)
+{
+    if (!m_flowIdleTimeout.IsStrictlyPositive() || m_flowLru.empty() ||
+        !m_idleEvictionEvent.IsExpired())
+    {
+        // flows only become active again: a pending timer is never late
+        return;
+    }
+
+    const FlowHandler& lruFlow = m_flowHandlerMap.find(m_flowLru.back())->second;
+    Time idleDeadline = lruFlow.m_lastRxTime + m_flowIdleTimeout;
+    m_idleEvictionEvent = Simulator::Schedule(idleDeadline - Simulator::Now(),
+                                              &BurstSink::IdleEvictionExpired,
+                                              this);
+}
+
+void
+BurstSink::IdleEvictionExpired(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    while (!m_flowLru.empty())
+    {
+        auto itFlow = m_flowHandlerMap.find(m_flowLru.back());
+        if (itFlow->second.m_lastRxTime + m_flowIdleTimeout > Simulator::Now())
+        {
+            break;
+        }
+        EvictFlow(itFlow);
+    }
+
+    ScheduleIdleEviction();
+}
+
+void
+BurstSink::SendFeedback(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto& flow : m_flowHandlerMap)
+    {
+        FlowHandler& flowHandler = flow.second;
+        FeedbackStats& stats = flowHandler.m_feedback;
+
+        BurstFeedbackHeader feedback;
+        feedback.SetInterval(m_feedbackInterval);
+        feedback.SetReceivedBursts(stats.m_receivedBursts);
+        feedback.SetLostBursts(stats.m_lostBursts);
+        feedback.SetReceivedBytes(stats.m_receivedBytes);
+        if (stats.m_delaySamples > 0)
+        {
+            Time meanDelay = stats.m_delaySum / static_cast<int64_t>(stats.m_delaySamples);
+            feedback.SetMeanDelay(meanDelay);
+            if (stats.m_hasLastMeanDelay)
+            {
+                feedback.SetDelayDelta(meanDelay - stats.m_lastMeanDelay);
+            }
+            stats.m_lastMeanDelay = meanDelay;
+            stats.m_hasLastMeanDelay = true;
+        }
+        else
+        {
+            // no fragment received: report the last known delay with no variation
+            feedback.SetMeanDelay(stats.m_lastMeanDelay);
+        }
+
+        Ptr<Packet> packet = Create<Packet>();
+        packet->AddHeader(feedback);
+        packet->AddHeader(BurstControlHeader(BurstControlHeader::Feedback));
+        if (flowHandler.m_socket->GetSocketType() == Socket::NS3_SOCK_STREAM)
+        {
+            packet->AddHeader(BurstStreamHeader(packet->GetSize()));
+        }
+        if (flowHandler.m_socket->SendTo(packet, 0, flowHandler.m_peerAddress) < 0)
+        {
+            NS_LOG_WARN("Unable to send reception report " << feedback << " to " << flow.first);
+        }
+        NS_LOG_LOGIC("Sent reception report " << feedback << " to " << flow.first);
+        m_txFeedbackTrace(flowHandler.m_peerAddress, feedback);
+
+        // keep the mean delay of the last interval to compute the next variation
+        stats.m_receivedBursts = 0;
+        stats.m_lostBursts = 0;
+        stats.m_receivedBytes = 0;
+        stats.m_delaySum = Seconds(0);
+        stats.m_delaySamples = 0;
+    }
+
+    m_feedbackEvent = Simulator::Schedule(m_feedbackInterval, &BurstSink::SendFeedback, this);
+}
+
+void
+BurstSink::FragmentReceived(FlowHandler& flowHandler,
                             const Ptr<Packet>& f,
                             const Address& from,
                             const Address& localAddress)
 {
     NS_LOG_FUNCTION(this << f);
 
+    // the only deserialization of the header: later, its bytes are just removed
     SeqTsSizeFragHeader header;
-    f->PeekHeader(header);
-    NS_ABORT_IF(header.GetSize() == 0);
+    uint32_t headerSize = 0;
+    bool hasMetadata = true;
+    if (m_headerFormat == SeqTsSizeFragHeader::Compact)
+    {
+        CompactFragHeader compactHeader;
+        headerSize = f->PeekHeader(compactHeader);
+        hasMetadata = compactHeader.HasMetadata();
+        header = compactHeader;
+    }
+    else
+    {
+        headerSize = f->PeekHeader(header);
+    }
+    NS_ABORT_IF(hasMetadata && header.GetSize() == 0);
 
     m_totRxFragments++;
+    flowHandler.m_feedback.m_receivedBytes += f->GetSize();
+    if (hasMetadata)
+    {
+        flowHandler.m_feedback.m_delaySum += Simulator::Now() - header.GetTs();
+        flowHandler.m_feedback.m_delaySamples++;
+    }
     m_rxFragmentTrace(f,
                       from,
                       localAddress,
                       header); // TODO should fragment still include header in trace?
 
+    if (!flowHandler.m_started || header.GetSeq() > flowHandler.m_highestBurstSeq)
+    {
+        // fragment of new burst: slide the window forward
+        NS_LOG_LOGIC("Start merging new burst seq " << header.GetSeq() << " (previous highest="
+                                                    << flowHandler.m_highestBurstSeq << ")");
+        if (flowHandler.m_started)
+        {
+            CountMissingBursts(flowHandler, header.GetSeq());
+        }
+        else
+        {
+            flowHandler.m_firstBurstSeq = header.GetSeq();
+        }
+        flowHandler.m_started = true;
+        flowHandler.m_highestBurstSeq = header.GetSeq();
+    }
+    else if (header.GetSeq() + flowHandler.m_bursts.size() <= flowHandler.m_highestBurstSeq)
+    {
+        NS_LOG_LOGIC("Ignoring fragment from burst outside of the reassembly window. Fragment "
+                     "burst seq="
+                     << header.GetSeq() << ", highest burst seq=" << flowHandler.m_highestBurstSeq);
+        return;
+    }
+
+    BurstHandler& burstHandler =
+        flowHandler.m_bursts[header.GetSeq() % flowHandler.m_bursts.size()];
+    if (!burstHandler.m_active || burstHandler.m_buffer.GetBurstSeq() != header.GetSeq())
+    {
+        // the handler was assigned to a burst that fell off the window
+        ResetBurstHandler(flowHandler, burstHandler, header, hasMetadata, from);
+        ScheduleReassemblyTimeout(flowHandler, from);
+    }
+
     NS_LOG_DEBUG("Get BurstHandler for from="
-                 << from << " with m_currentBurstSeq=" << burstHandler.m_currentBurstSeq
-                 << ", m_fragmentsMerged=" << burstHandler.m_fragmentsMerged
-                 << ", m_unorderedFragments.size ()=" << burstHandler.m_unorderedFragments.size()
-                 << ", m_burstBuffer.GetSize ()=" << burstHandler.m_burstBuffer->GetSize()
+                 << from << " with burst seq=" << burstHandler.m_buffer.GetBurstSeq()
+                 << ", fragments received=" << burstHandler.m_buffer.GetReceivedFragments()
+                 << ", bytes received=" << burstHandler.m_buffer.GetReceivedBytes()
                  << ", for fragment with header: " << header);
 
-    if (header.GetSeq() < burstHandler.m_currentBurstSeq)
+    if (burstHandler.m_complete)
     {
-        NS_LOG_LOGIC("Ignoring fragment from previous burst. Fragment burst seq="
-                     << header.GetSeq()
-                     << ", current burst seq=" << burstHandler.m_currentBurstSeq);
+        NS_LOG_LOGIC("Ignoring fragment from already received burst seq=" << header.GetSeq());
         return;
     }
-
-    if (header.GetSeq() > burstHandler.m_currentBurstSeq)
+    if (burstHandler.m_timedOut)
     {
-        // fragment of new burst: discard previous burst if incomplete
-        NS_LOG_LOGIC("Start mering new burst seq "
-                     << header.GetSeq() << " (previous=" << burstHandler.m_currentBurstSeq << ")");
+        NS_LOG_LOGIC("Ignoring fragment from timed out burst seq=" << header.GetSeq());
+        return;
+    }
 
-        burstHandler.m_currentBurstSeq = header.GetSeq();
-        burstHandler.m_fragmentsMerged = 0;
-        burstHandler.m_unorderedFragments.clear();
-        burstHandler.m_burstBuffer = Create<Packet>(0);
+    if (!hasMetadata && !burstHandler.m_hasMetadata)
+    {
+        // keep the payload aside until the metadata of the burst arrives
+        f->RemoveAtStart(headerSize);
+        burstHandler.m_earlyFragments.push_back(std::make_pair(header.GetFragSeq(), f));
+        burstHandler.m_nackTime = Simulator::Now() + m_nackInterval;
+        ScheduleNack(flowHandler, from);
+        return;
+    }
+    if (!hasMetadata)
+    {
+        // complete the compact header with the metadata of the burst
+        uint32_t fragSeq = header.GetFragSeq();
+        header = burstHandler.m_header;
+        header.SetFragSeq(fragSeq);
+        flowHandler.m_feedback.m_delaySum += Simulator::Now() - header.GetTs();
+        flowHandler.m_feedback.m_delaySamples++;
+    }
+    else if (!burstHandler.m_hasMetadata)
+    {
+        // the metadata of the burst arrived: account for the fragments received so far
+        NS_LOG_LOGIC("Metadata of burst seq " << header.GetSeq() << " received after "
+                                              << burstHandler.m_earlyFragments.size()
+                                              << " fragments");
+        burstHandler.m_hasMetadata = true;
+        burstHandler.m_header = header;
+        burstHandler.m_buffer.Reset(header.GetSeq(),
+                                    header.GetFrags(),
+                                    header.GetSize(),
+                                    burstHandler.m_buffer.IsStoringPayloads() &&
+                                        header.GetSize() <= std::numeric_limits<uint32_t>::max(),
+                                    header.GetParity(),
+                                    BurstFecCodec::Scheme(header.GetFecScheme()));
+        for (const auto& early : burstHandler.m_earlyFragments)
+        {
+            StoreFragment(burstHandler, early.first, early.second);
+        }
+        burstHandler.m_earlyFragments.clear();
     }
 
-    if (header.GetSeq() == burstHandler.m_currentBurstSeq)
+    // fragment of a burst within the window: store its payload in its slot
+    f->RemoveAtStart(headerSize);
+    if (!StoreFragment(burstHandler, header.GetFragSeq(), f))
     {
-        // fragment of current burst
-        NS_ASSERT_MSG(header.GetFragSeq() >= burstHandler.m_fragmentsMerged,
-                      header.GetFragSeq() << " >= " << burstHandler.m_fragmentsMerged);
+        return;
+    }
+    burstHandler.m_nackTime = Simulator::Now() + m_nackInterval;
+    NS_LOG_LOGIC("Fragments received " << burstHandler.m_buffer.GetReceivedFragments() << "/"
+                                       << header.GetFrags() << " for burst " << header.GetSeq());
 
-        NS_LOG_DEBUG("fragment sequence=" << header.GetFragSeq() << ", fragments merged="
-                                          << burstHandler.m_fragmentsMerged);
-        if (header.GetFragSeq() == burstHandler.m_fragmentsMerged)
+    // check if burst is complete
+    if (burstHandler.m_buffer.IsComplete())
+    {
+        if (burstHandler.m_buffer.GetReceivedDataFragments() == header.GetFrags())
         {
-            // following packet: merge it
-            f->RemoveHeader(header);
-            burstHandler.m_burstBuffer->AddAtEnd(f);
-            burstHandler.m_fragmentsMerged++;
-            NS_LOG_LOGIC("Fragments merged " << burstHandler.m_fragmentsMerged << "/"
-                                             << header.GetFrags() << " for burst "
-                                             << header.GetSeq());
-
-            // if present, merge following unordered fragments
-            auto nextFragmentIt = burstHandler.m_unorderedFragments.begin();
-            while (
-                nextFragmentIt !=
-                    burstHandler.m_unorderedFragments.end() && // there are unordered packets
-                nextFragmentIt->first ==
-                    burstHandler.m_fragmentsMerged) // the following fragment was already received
-            {
-                Ptr<Packet> storedFragment = nextFragmentIt->second;
-                storedFragment->RemoveHeader(header);
-                burstHandler.m_burstBuffer->AddAtEnd(storedFragment);
-                burstHandler.m_fragmentsMerged++;
-                NS_LOG_LOGIC("Unordered fragments merged " << burstHandler.m_fragmentsMerged << "/"
-                                                           << header.GetFrags() << " for burst "
-                                                           << header.GetSeq());
-
-                nextFragmentIt = burstHandler.m_unorderedFragments.erase(nextFragmentIt);
-            }
+            // all data fragments have been received
+            NS_ASSERT_MSG(burstHandler.m_buffer.GetReceivedBytes() == header.GetSize(),
+                          burstHandler.m_buffer.GetReceivedBytes() << " == " << header.GetSize());
         }
         else
         {
-            // add to unordered fragments buffer
-            NS_LOG_LOGIC("Add unordered fragment " << header.GetFragSeq() << " of burst "
-                                                   << header.GetSeq() << " to buffer ");
-            burstHandler.m_unorderedFragments.insert(
-                std::pair<uint16_t, const Ptr<Packet>>(header.GetFragSeq(), f));
+            // the missing data fragments can be recovered from the parity fragments
+            NS_LOG_LOGIC("Recovering "
+                         << header.GetFrags() - burstHandler.m_buffer.GetReceivedDataFragments()
+                         << " data fragments of burst " << header.GetSeq() << " with FEC");
+            m_totFecRecoveredBursts++;
         }
-    }
-
-    // check if burst is complete
-    if (burstHandler.m_fragmentsMerged == header.GetFrags())
-    {
-        // all fragments have been merged
-        NS_ASSERT_MSG(burstHandler.m_burstBuffer->GetSize() == header.GetSize(),
-                      burstHandler.m_burstBuffer->GetSize() << " == " << header.GetSize());
 
         NS_LOG_LOGIC("Burst received: " << header.GetFrags() << " fragments for a total of "
                                         << header.GetSize() << " B");
+        burstHandler.m_complete = true;
         m_totRxBursts++;
-        m_rxBurstTrace(burstHandler.m_burstBuffer,
-                       from,
-                       localAddress,
-                       header); // TODO header size does not include payload, why?
+        flowHandler.m_feedback.m_receivedBursts++;
+        ScheduleReassemblyTimeout(flowHandler, from);
+
+        if (burstHandler.m_buffer.IsStoringPayloads())
+        {
+            m_rxBurstTrace(burstHandler.m_buffer.AssembleBurst(),
+                           from,
+                           localAddress,
+                           header); // TODO header size does not include payload, why?
+        }
+        else if (!m_rxBurstTrace.IsEmpty())
+        {
+            // bursts are not materialized: only the size of the burst is traced
+            // bursts larger than 4 GB are traced with an empty packet
+            uint64_t size = header.GetSize();
+            Ptr<Packet> burst =
+                Create<Packet>(size <= std::numeric_limits<uint32_t>::max() ? size : 0);
+            m_rxBurstTrace(burst, from, localAddress, header);
+        }
+
+        if (burstHandler.m_nackRounds > 0)
+        {
+            m_recoveredBurstTrace(from,
+                                  localAddress,
+                                  header,
+                                  burstHandler.m_nackRounds,
+                                  Simulator::Now() - burstHandler.m_firstNackTime);
+        }
+
+        if (m_playoutDelay.IsStrictlyPositive())
+        {
+            EnqueueFrame(flowHandler, header, from);
+        }
+        return;
+    }
+
+    ScheduleNack(flowHandler, from);
+}
+
+Time
+BurstSink::GetNextVsync(const PlayoutBuffer& playout, Time time) const
+{
+    NS_ASSERT(playout.m_started);
+    Time period = Seconds(1.0 / m_playoutFrameRate);
+
+    // vsyncs are counted from the origin, so that their period does not accumulate rounding
+    int64_t elapsed = (time - playout.m_vsyncOrigin).GetTimeStep();
+    int64_t vsyncs = elapsed / period.GetTimeStep(); // rounded up if negative
+    if (vsyncs * period.GetTimeStep() < elapsed)
+    {
+        vsyncs++;
+    }
+    return playout.m_vsyncOrigin + period * vsyncs;
+}
+
+void
+BurstSink::EnqueueFrame(FlowHandler& flowHandler,
+                        const SeqTsSizeFragHeader& header,
+                        const Address& from)
+{
+    NS_LOG_FUNCTION(this << header << from);
+    PlayoutBuffer& playout = flowHandler.m_playout;
+    Time now = Simulator::Now();
+
+    if (!playout.m_started)
+    {
+        // the first frame is due exactly a PlayoutDelay after its generation
+        playout.m_started = true;
+        playout.m_vsyncOrigin = header.GetTs() + m_playoutDelay;
+    }
+    if (playout.m_hasDisplayed && header.GetSeq() <= playout.m_lastDisplayedSeq)
+    {
+        NS_LOG_LOGIC("Frame " << header.GetSeq() << " skipped: frame "
+                              << playout.m_lastDisplayedSeq << " already displayed");
+        m_totSkippedFrames++;
+        m_frameSkippedTrace(from, header);
+        return;
+    }
+
+    PlayoutFrame frame;
+    frame.m_header = header;
+    frame.m_target = GetNextVsync(playout, header.GetTs() + m_playoutDelay);
+    frame.m_display = std::max(frame.m_target, GetNextVsync(playout, now));
+    if (playout.m_hasDisplayed && frame.m_display <= playout.m_lastDisplayTime)
+    {
+        // the current vsync has already displayed a frame
+        frame.m_display = playout.m_lastDisplayTime + Seconds(1.0 / m_playoutFrameRate);
+    }
+    NS_LOG_LOGIC("Frame " << header.GetSeq() << " due at " << frame.m_target.As(Time::S)
+                          << ", displayed at " << frame.m_display.As(Time::S));
+    playout.m_frames[header.GetSeq()] = frame;
+    SchedulePlayout(flowHandler, from);
+}
+
+void
+BurstSink::SchedulePlayout(FlowHandler& flowHandler, const Address& from)
+{
+    PlayoutBuffer& playout = flowHandler.m_playout;
+    playout.m_vsyncEvent.Cancel();
+    if (playout.m_frames.empty())
+    {
+        return;
+    }
+
+    Time nextDisplay = Time::Max();
+    for (const auto& frame : playout.m_frames)
+    {
+        nextDisplay = std::min(nextDisplay, frame.second.m_display);
+    }
+    playout.m_vsyncEvent = Simulator::Schedule(nextDisplay - Simulator::Now(),
+                                               &BurstSink::PlayoutVsync,
+                                               this,
+                                               from);
+}
+
+void
+BurstSink::PlayoutVsync(Address from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    auto itFlow = m_flowHandlerMap.find(FlowKey(from));
+    if (itFlow == m_flowHandlerMap.end())
+    {
+        return;
+    }
+
+    PlayoutBuffer& playout = itFlow->second.m_playout;
+    Time now = Simulator::Now();
+    auto itDisplay = playout.m_frames.end();
+    for (auto it = playout.m_frames.begin(); it != playout.m_frames.end(); ++it)
+    {
+        if (it->second.m_display <= now)
+        {
+            itDisplay = it;
+        }
+    }
+
+    if (itDisplay != playout.m_frames.end())
+    {
+        // the most recent frame due supersedes the older ones, whether due or still late
+        for (auto it = playout.m_frames.begin(); it != itDisplay; ++it)
+        {
+            NS_LOG_LOGIC("Frame " << it->first << " skipped: frame " << itDisplay->first
+                                  << " displayed first");
+            m_totSkippedFrames++;
+            m_frameSkippedTrace(from, it->second.m_header);
+        }
+
+        Time period = Seconds(1.0 / m_playoutFrameRate);
+        if (playout.m_hasDisplayed && now - playout.m_lastDisplayTime > period)
+        {
+            Time duration = now - playout.m_lastDisplayTime - period;
+            NS_LOG_LOGIC("Playout stalled for " << duration.As(Time::MS));
+            m_totPlayoutStalls++;
+            m_playoutStallTrace(from, duration);
+        }
+
+        const PlayoutFrame& frame = itDisplay->second;
+        Time lateness = now - frame.m_target;
+        if (lateness.IsStrictlyPositive())
+        {
+            m_totLateFrames++;
+        }
+        m_totDisplayedFrames++;
+        playout.m_hasDisplayed = true;
+        playout.m_lastDisplayedSeq = itDisplay->first;
+        playout.m_lastDisplayTime = now;
+        m_frameDisplayedTrace(from, frame.m_header, now - frame.m_header.GetTs(), lateness);
+        playout.m_frames.erase(playout.m_frames.begin(), std::next(itDisplay));
+    }
+
+    SchedulePlayout(itFlow->second, from);
+}
+
+bool
+BurstSink::StoreFragment(BurstHandler& burstHandler, uint32_t fragSeq, Ptr<Packet> payload)
+{
+    NS_LOG_FUNCTION(this << fragSeq << payload);
+
+    if (burstHandler.m_buffer.IsStoringPayloads())
+    {
+        return burstHandler.m_buffer.AddFragment(fragSeq, payload);
     }
+    return burstHandler.m_buffer.AddFragment(fragSeq, payload->GetSize());
 }
 
 void
 BurstSink::HandlePeerClose(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
+    m_deframers.erase(socket);
 }
 
 void
 BurstSink::HandlePeerError(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
+    m_deframers.erase(socket);
 }
 
 void
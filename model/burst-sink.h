@@ -10,17 +10,24 @@
 #ifndef BURST_SINK_H
 #define BURST_SINK_H
 
+#include "burst-control-header.h"
+#include "burst-flow-key.h"
+#include "burst-reassembly-buffer.h"
+#include "burst-stream-deframer.h"
 #include "seq-ts-size-frag-header.h"
 
 #include "ns3/address.h"
 #include "ns3/application.h"
 #include "ns3/event-id.h"
-#include "ns3/inet-socket-address.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/socket.h"
 #include "ns3/traced-callback.h"
 
+#include <list>
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -44,25 +51,102 @@ class Packet;
  *
  * This application was based on PacketSink, and modified to accept traffic
  * generated by BurstyApplication.
- * The application assumes to be on top of a UDP socket, thus receiving UDP
- * datagrams rather than bytestreams.
+ * The application is usually on top of a UDP socket, thus receiving UDP
+ * datagrams, one per fragment. Over TCP, each accepted socket is a byte
+ * stream carrying length-prefixed fragments (see BurstStreamHeader), split
+ * back into fragments by a BurstStreamDeframer across reads.
  *
  * The sink tries to aggregate single packets (fragments) into a single packet
  * burst. To do so, it gathers information from SeqTsSizeFragHeader, which all
  * received packets should have.
+ * Flows are told apart by the IPv4 or IPv6 address and the port of their
+ * source (see FlowKey), so that multiple BurstyApplications on the same node
+ * are reassembled independently.
+ * The flow table can be bounded to MaxFlows flows, evicting the least
+ * recently active flow to make room for a new one, and flows receiving no
+ * fragment for a FlowIdleTimeout are evicted as well, so that a sink serving
+ * an open population of users holds a bounded amount of memory. Incomplete
+ * bursts of an evicted flow are discarded, and a later fragment from the same
+ * source starts a new flow.
  * It then makes the following assumptions:
  * - Being based on a UDP socket, packets might arrive out-of-order. Within a
  * burst, BurstSink will reorder the received packets.
- * - While receiving burst n, if a fragment from burst k<n is received, the
- * fragment is discarded
- * - While receiving burst n, if a fragment from burst k>n is received,
- * burst n is discarded and burst k will start being buffered.
+ * - Up to ReassemblyWindow bursts per flow are reassembled concurrently: if n
+ * is the highest burst sequence number received so far, bursts n-K+1,...,n
+ * are being buffered, with K the size of the window.
+ * - If a fragment from burst k<=n-K is received, the fragment is discarded.
+ * - If a fragment from burst k>n is received, the window slides forward and
+ * the incomplete bursts falling off the window are discarded.
  * - If all fragments from a burst are received, the burst is successfully
- * received.
+ * received, even if more recent bursts have been received in the meantime.
+ *
+ * With a ReassemblyWindow of 1, while receiving burst n, a fragment of
+ * burst k>n discards burst n altogether.
+ *
+ * Optionally, a ReassemblyTimeout can be set: a burst that is not completed
+ * within the timeout since the reception of its first fragment is discarded,
+ * releasing its memory, and further fragments of the burst are ignored.
+ * A single timer per flow tracks the earliest deadline among the bursts in
+ * its reassembly window.
+ * Whenever an incomplete burst is discarded, either because of the timeout
+ * or because it falls off the reassembly window, the BurstPartialRx trace
+ * reports the fraction of data fragments and bytes received.
+ *
+ * If the burst is protected by forward error correction, as announced by the
+ * header of its fragments, parity fragments are stored along with the data
+ * fragments, and the burst is received as soon as the missing data fragments
+ * can be recovered, e.g., with Reed-Solomon, once any frags out of
+ * frags+parity fragments are received (see BurstFecCodec).
+ *
+ * As a low-latency alternative to FEC, a NackInterval can be set: when no
+ * fragment of an incomplete burst is received for a NackInterval, a NACK
+ * listing the missing data fragments is sent back to the source on the same
+ * flow, and repeated every NackInterval up to MaxNackRounds times. Bursts
+ * completed after at least one NACK are reported by the BurstRecovered trace,
+ * together with the time elapsed since the first NACK.
+ *
+ * If a FeedbackInterval is set, every FeedbackInterval the sink sends back
+ * to the source of each flow a BurstFeedbackHeader reporting
+ * the bursts received and lost during the interval, the received bytes, the
+ * mean one-way delay of the fragments, measured from the time stamp of their
+ * SeqTsSizeHeader, and its variation since the previous report. Bursts of
+ * which no fragment is received are counted as lost from the gaps in the
+ * burst sequence numbers, once they fall off the reassembly window. A
+ * BurstyApplication with a BurstRateController uses these reports to adapt
+ * its target data rate. Over stream sockets, NACKs and reception reports are
+ * preceded by a BurstStreamHeader with their size, as the fragments are.
+ *
+ * The HeaderFormat must match the one of the BurstyApplication. With the
+ * CompactFragHeader, only fragment 0 and the parity fragments carry the
+ * metadata of the burst: the payloads of fragments received before any of
+ * them are kept aside, and merged into the burst once its metadata arrives.
+ * The one-way delay of the fragments is then measured from the time stamp
+ * of the burst, and FragmentRx traces headers without metadata as received.
  *
  * Traces are sent when a fragment is received and when a whole burst is
  * successfully received.
  *
+ * If a PlayoutDelay is set, received bursts are handed over to a playout
+ * stage emulating the display of the frames they carry. The vsync clock of
+ * each flow ticks at PlayoutFrameRate, which should match the frame rate of
+ * the stream, and is anchored a PlayoutDelay after the generation of the
+ * first received frame. A frame is due at the first vsync at least a
+ * PlayoutDelay after its generation: frames received in time are displayed
+ * at their vsync (FrameDisplayed), the others at the first vsync after their
+ * reception, with the lateness traced. If several frames are due at a vsync,
+ * only the most recent one is displayed, and the older frames are skipped
+ * (FrameSkipped), as are frames received after a more recent frame was
+ * displayed. Whenever a frame is displayed after one or more vsyncs without a
+ * new frame, e.g., because bursts were lost or late, a PlayoutStall is traced.
+ *
+ * Reassembling the burst into a single packet is only needed by the BurstRx
+ * trace. Depending on the ReassemblyMode, fragment payloads are stored and
+ * merged into the burst, or the sink only accounts for the received
+ * fragments and bytes. In the latter case, BurstRx is fired with a packet of
+ * the size of the burst not built from the received fragments.
+ * By default, bursts are materialized only if some callback is connected to
+ * the BurstRx trace when the first fragment of the burst is received.
+ *
  */
 class BurstSink : public Application
 {
@@ -73,6 +157,16 @@ class BurstSink : public Application
      */
     static TypeId GetTypeId(void);
 
+    /**
+     * How received bursts are reassembled
+     */
+    enum ReassemblyMode
+    {
+        Auto = 0,      //!< Materialize bursts only if BurstRx has some callback connected
+        Materialize,   //!< Always merge the fragment payloads into the burst
+        ByteAccounting //!< Only account for received fragments and bytes
+    };
+
     BurstSink();
     virtual ~BurstSink();
 
@@ -91,6 +185,51 @@ class BurstSink : public Application
      */
     uint64_t GetTotalRxBursts() const;
 
+    /**
+     * @return the total bursts received in this sink app after recovering
+     * some of their data fragments with FEC
+     */
+    uint64_t GetTotalFecRecoveredBursts() const;
+
+    /**
+     * @return the total flows evicted from the flow table, either because idle
+     * or to make room for new flows
+     */
+    uint64_t GetTotalEvictedFlows() const;
+
+    /**
+     * @return the number of flows currently in the flow table
+     */
+    uint32_t GetActiveFlows() const;
+
+    /**
+     * @return the memory currently held by the flow table [B], including the
+     * reassembly buffers and the fragment payloads they store
+     */
+    uint64_t GetFlowTableMemory() const;
+
+    /**
+     * @return the total frames displayed by the playout stage, on time or late
+     */
+    uint64_t GetTotalDisplayedFrames() const;
+
+    /**
+     * @return the total frames displayed by the playout stage after their target vsync
+     */
+    uint64_t GetTotalLateFrames() const;
+
+    /**
+     * @return the total received frames skipped by the playout stage, because
+     * a more recent frame was displayed first
+     */
+    uint64_t GetTotalSkippedFrames() const;
+
+    /**
+     * @return the total playout stalls, i.e., the times a frame was displayed
+     * after one or more vsyncs without a new frame
+     */
+    uint64_t GetTotalPlayoutStalls() const;
+
     /**
      * @return pointer to listening socket
      */
@@ -114,6 +253,89 @@ class BurstSink : public Application
                                           const Address& to,
                                           const SeqTsSizeFragHeader& header);
 
+    /**
+     * TracedCallback signature for an incomplete burst being discarded
+     *
+     * @param from From address
+     * @param to Local address
+     * @param header The SeqTsSize header of the first fragment received for the burst
+     * @param fragmentFraction The fraction of fragments of the burst received
+     * @param byteFraction The fraction of bytes of the burst received
+     */
+    typedef void (*PartialBurstCallback)(const Address& from,
+                                         const Address& to,
+                                         const SeqTsSizeFragHeader& header,
+                                         double fragmentFraction,
+                                         double byteFraction);
+
+    /**
+     * TracedCallback signature for a NACK sent back to the source of a burst
+     *
+     * @param to The address of the source of the burst
+     * @param nack The NACK header, listing the missing fragments
+     */
+    typedef void (*NackCallback)(const Address& to, const BurstNackHeader& nack);
+
+    /**
+     * TracedCallback signature for a burst completed after sending NACKs
+     *
+     * @param from From address
+     * @param to Local address
+     * @param header The SeqTsSize header of the burst
+     * @param nackRounds The number of NACKs sent for the burst
+     * @param recoveryDelay The time elapsed since the first NACK was sent
+     */
+    typedef void (*RecoveredBurstCallback)(const Address& from,
+                                           const Address& to,
+                                           const SeqTsSizeFragHeader& header,
+                                           uint32_t nackRounds,
+                                           Time recoveryDelay);
+
+    /**
+     * TracedCallback signature for a reception report sent back to the source of a flow
+     *
+     * @param to The address of the source of the flow
+     * @param feedback The reception report
+     */
+    typedef void (*FeedbackCallback)(const Address& to, const BurstFeedbackHeader& feedback);
+
+    /**
+     * TracedCallback signature for a flow evicted from the flow table
+     *
+     * @param from The address of the source of the flow
+     * @param idleTime The time elapsed since the last fragment of the flow was received
+     */
+    typedef void (*FlowEvictedCallback)(const Address& from, Time idleTime);
+
+    /**
+     * TracedCallback signature for a frame displayed by the playout stage
+     *
+     * @param from The address of the source of the flow
+     * @param header The SeqTsSize header of the burst carrying the frame
+     * @param latency The time elapsed since the burst was generated
+     * @param lateness The time elapsed since the target vsync of the frame, zero if on time
+     */
+    typedef void (*FrameDisplayedCallback)(const Address& from,
+                                           const SeqTsSizeFragHeader& header,
+                                           Time latency,
+                                           Time lateness);
+
+    /**
+     * TracedCallback signature for a frame skipped by the playout stage
+     *
+     * @param from The address of the source of the flow
+     * @param header The SeqTsSize header of the burst carrying the frame
+     */
+    typedef void (*FrameSkippedCallback)(const Address& from, const SeqTsSizeFragHeader& header);
+
+    /**
+     * TracedCallback signature for a playout stall
+     *
+     * @param from The address of the source of the flow
+     * @param duration The time the previous frame was displayed for beyond its vsync period
+     */
+    typedef void (*PlayoutStallCallback)(const Address& from, Time duration);
+
   protected:
     virtual void DoDispose(void);
 
@@ -123,10 +345,21 @@ class BurstSink : public Application
     virtual void StopApplication(void);  // Called at time specified by Stop
 
     /**
-     * @brief Handle a fragment received by the application
+     * @brief Handle the packets received by the application
      * @param socket the receiving socket
      */
     void HandleRead(Ptr<Socket> socket);
+    /**
+     * @brief Handle a fragment received by the application, finding or creating its flow
+     * @param socket the receiving socket
+     * @param fragment the received fragment
+     * @param from the address of the source
+     * @param localAddress the local address of the socket
+     */
+    void HandleFragment(Ptr<Socket> socket,
+                        Ptr<Packet> fragment,
+                        const Address& from,
+                        const Address& localAddress);
     /**
      * @brief Handle an incoming connection
      * @param socket the incoming connection socket
@@ -146,69 +379,280 @@ class BurstSink : public Application
 
     /**
      * @brief Simple burst handler
-     * Contains information regarding the current burst sequence number
+     * Contains the reassembly state of a single burst
      */
     struct BurstHandler
     {
-        uint64_t m_currentBurstSeq{0}; //!< Current burst sequence number
-        uint16_t m_fragmentsMerged{
-            0}; //!< Number of ordered fragments received and merged for the current burst
-        std::map<uint16_t, const Ptr<Packet>>
-            m_unorderedFragments; //!< The fragments received out-of-order, still to be merged
-        Ptr<Packet> m_burstBuffer{
-            Create<Packet>(0)}; //!< The buffer containing the ordered received fragments
+        bool m_active{false};           //!< True if the handler is assigned to a burst
+        bool m_complete{false};         //!< True if the burst has been successfully received
+        bool m_timedOut{false};         //!< True if the reassembly timeout has expired
+        SeqTsSizeFragHeader m_header;   //!< Header of the first fragment received
+        Time m_deadline;                //!< Time by which the burst should be completed
+        Time m_nackTime;                //!< Time at which a NACK is due if the burst is incomplete
+        uint32_t m_nackRounds{0};       //!< Number of NACKs sent for the burst
+        Time m_firstNackTime;           //!< Time at which the first NACK was sent
+        BurstReassemblyBuffer m_buffer; //!< The fragments received for the burst
+        bool m_hasMetadata{true};       //!< False until a fragment with the burst metadata arrives
+
+        /// Payloads of the fragments received before the metadata of the burst
+        std::vector<std::pair<uint32_t, Ptr<Packet>>> m_earlyFragments;
     };
 
+    /**
+     * @brief Reception statistics of a flow over the current feedback interval
+     */
+    struct FeedbackStats
+    {
+        uint32_t m_receivedBursts{0};   //!< Bursts received during the interval
+        uint32_t m_lostBursts{0};       //!< Bursts discarded or never received during the interval
+        uint64_t m_receivedBytes{0};    //!< Bytes received during the interval
+        Time m_delaySum;                //!< Sum of the one-way delays of the fragments received
+        uint64_t m_delaySamples{0};     //!< Number of fragments whose delay is summed
+        Time m_lastMeanDelay;           //!< Mean one-way delay reported in the previous interval
+        bool m_hasLastMeanDelay{false}; //!< True once a mean one-way delay has been reported
+    };
+
+    /**
+     * @brief A received frame waiting for its vsync in the playout buffer
+     */
+    struct PlayoutFrame
+    {
+        SeqTsSizeFragHeader m_header; //!< Header of the burst carrying the frame
+        Time m_target;                //!< Vsync the frame should be displayed at
+        Time m_display;               //!< Vsync the frame will be displayed at, if not skipped
+    };
+
+    /**
+     * @brief Playout stage of a flow
+     * Frames are displayed at the vsyncs of a clock anchored to the first
+     * received frame, a PlayoutDelay after its generation.
+     */
+    struct PlayoutBuffer
+    {
+        bool m_started{false};                     //!< True once the vsync clock is anchored
+        Time m_vsyncOrigin;                        //!< A vsync instant, anchoring the clock
+        std::map<uint64_t, PlayoutFrame> m_frames; //!< Frames waiting for display, by seq
+        bool m_hasDisplayed{false};                //!< True once a frame has been displayed
+        uint64_t m_lastDisplayedSeq{0};            //!< Sequence number of the last frame displayed
+        Time m_lastDisplayTime;                    //!< Vsync the last frame was displayed at
+        EventId m_vsyncEvent;                      //!< Vsync of the earliest frame to display
+    };
+
+    /**
+     * @brief Flow handler
+     * Contains the reassembly window of the bursts of a single flow.
+     * Burst with sequence number s is handled by m_bursts[s % m_bursts.size ()].
+     */
+    struct FlowHandler
+    {
+        bool m_started{false};                //!< True once the first fragment has been received
+        uint64_t m_firstBurstSeq{0};          //!< Burst sequence number of the first fragment
+        uint64_t m_highestBurstSeq{0};        //!< Highest burst sequence number received
+        std::vector<BurstHandler> m_bursts;   //!< Handlers of the bursts within the window
+        Address m_peerAddress;                //!< Address of the source of the flow
+        Address m_localAddress;               //!< Local address the flow is received on
+        EventId m_timeoutEvent;               //!< Reassembly timeout of the earliest deadline
+        Ptr<Socket> m_socket;                 //!< Socket the flow is received on, used for NACKs
+        EventId m_nackEvent;                  //!< NACK timer of the earliest due NACK
+        FeedbackStats m_feedback;             //!< Reception statistics for the next report
+        Time m_lastRxTime;                    //!< Time the last fragment was received
+        std::list<FlowKey>::iterator m_lruIt; //!< Position of the flow in the LRU list
+        PlayoutBuffer m_playout;              //!< Playout stage of the flow, if enabled
+    };
+
+    /**
+     * @brief Reset a burst handler to start reassembling a new burst
+     * @param flowHandler the handler of the flow the burst belongs to
+     * @param burstHandler the burst handler to reset
+     * @param header the header of a fragment of the new burst
+     * @param hasMetadata whether the header carries the metadata of the burst
+     * @param from from address
+     */
+    void ResetBurstHandler(FlowHandler& flowHandler,
+                           BurstHandler& burstHandler,
+                           const SeqTsSizeFragHeader& header,
+                           bool hasMetadata,
+                           const Address& from);
+
+    /**
+     * @brief Discard an incomplete burst, releasing its memory and reporting it
+     * in the BurstPartialRx trace
+     * @param flowHandler the handler of the flow the burst belongs to
+     * @param burstHandler the handler of the incomplete burst
+     * @param from from address
+     */
+    void DiscardIncompleteBurst(FlowHandler& flowHandler,
+                                BurstHandler& burstHandler,
+                                const Address& from);
+
+    /**
+     * @brief Count as lost the bursts falling off the reassembly window without any of their
+     * fragments received, as the window slides forward
+     * @param flowHandler the handler of the flow, with the previous highest burst sequence number
+     * @param highestBurstSeq the new highest burst sequence number of the flow
+     */
+    void CountMissingBursts(FlowHandler& flowHandler, uint64_t highestBurstSeq);
+
+    /**
+     * @brief Schedule the reassembly timeout of a flow at the earliest
+     * deadline among its incomplete bursts
+     * @param flowHandler the handler of the flow
+     * @param from from address, identifying the flow
+     */
+    void ScheduleReassemblyTimeout(FlowHandler& flowHandler, const Address& from);
+
+    /**
+     * @brief Handle the expiration of the reassembly timeout of a flow
+     * @param from from address, identifying the flow
+     */
+    void ReassemblyTimeoutExpired(Address from);
+
+    /**
+     * @brief Schedule the NACK timer of a flow at the earliest time a NACK is
+     * due among its incomplete bursts, unless already scheduled
+     * @param flowHandler the handler of the flow
+     * @param from from address, identifying the flow
+     */
+    void ScheduleNack(FlowHandler& flowHandler, const Address& from);
+
+    /**
+     * @brief Handle the expiration of the NACK timer of a flow, sending the
+     * NACKs that are due
+     * @param from from address, identifying the flow
+     */
+    void NackTimerExpired(Address from);
+
+    /**
+     * @brief Send a NACK listing the missing data fragments of a burst
+     * @param flowHandler the handler of the flow the burst belongs to
+     * @param burstHandler the handler of the incomplete burst
+     * @param from from address, i.e., the source of the burst
+     */
+    void SendNack(FlowHandler& flowHandler, BurstHandler& burstHandler, const Address& from);
+
+    /**
+     * @brief Flow table, with the flows in order of last activity
+     */
+    typedef std::unordered_map<FlowKey, FlowHandler, FlowKeyHash> FlowTable;
+
+    /**
+     * @brief Evict a flow from the flow table, discarding its incomplete bursts
+     * @param itFlow the flow to evict
+     */
+    void EvictFlow(FlowTable::iterator itFlow);
+
+    /**
+     * @brief Schedule the eviction of the least recently active flow when it
+     * becomes idle, unless already scheduled
+     */
+    void ScheduleIdleEviction(void);
+
+    /**
+     * @brief Evict the flows that have been idle for FlowIdleTimeout
+     */
+    void IdleEvictionExpired(void);
+
+    /**
+     * @brief Send a reception report to the source of each flow and schedule
+     * the next one
+     */
+    void SendFeedback(void);
+
+    /**
+     * @brief Get the first vsync of a flow at or after a given time
+     * @param playout the playout stage of the flow, with an anchored vsync clock
+     * @param time the time
+     * @return the first vsync not earlier than time
+     */
+    Time GetNextVsync(const PlayoutBuffer& playout, Time time) const;
+
+    /**
+     * @brief Hand a received burst over to the playout stage of its flow
+     * @param flowHandler the handler of the flow the burst belongs to
+     * @param header the header of the burst
+     * @param from from address, identifying the flow
+     */
+    void EnqueueFrame(FlowHandler& flowHandler,
+                      const SeqTsSizeFragHeader& header,
+                      const Address& from);
+
+    /**
+     * @brief Schedule the next vsync of a flow at which a frame is displayed
+     * @param flowHandler the handler of the flow
+     * @param from from address, identifying the flow
+     */
+    void SchedulePlayout(FlowHandler& flowHandler, const Address& from);
+
+    /**
+     * @brief Display the most recent frame of a flow due at the current vsync,
+     * skipping the older ones
+     * @param from from address, identifying the flow
+     */
+    void PlayoutVsync(Address from);
+
+    /**
+     * @brief Store a fragment in the reassembly buffer of its burst, or only
+     * account for it if payloads are not stored
+     * @param burstHandler the handler of the burst
+     * @param fragSeq the sequence number of the fragment within the burst
+     * @param payload the payload of the fragment, without header
+     * @return false if the fragment is a duplicate or out of range, true otherwise
+     */
+    bool StoreFragment(BurstHandler& burstHandler, uint32_t fragSeq, Ptr<Packet> payload);
+
     /**
      * @brief Fragment received: assemble byte stream to extract SeqTsSizeFragHeader
+     * @param flowHandler the handler of the flow the fragment belongs to
      * @param f received fragment
      * @param from from address
      * @param localAddress local address
      *
      * The method assembles a received byte stream and extracts SeqTsSizeFragHeader
      * instances from the stream to export in a trace source.
+     * The header of each fragment is deserialized exactly once: the payload is
+     * then stripped of the header bytes, and the metadata of the burst is kept
+     * by its BurstHandler next to the stored payloads.
      */
-    void FragmentReceived(BurstHandler& burstHandler,
+    void FragmentReceived(FlowHandler& flowHandler,
                           const Ptr<Packet>& f,
                           const Address& from,
                           const Address& localAddress);
 
-    /**
-     * @brief Hashing for the Address class
-     * Needed to make Address the key of a map.
-     */
-    struct AddressHash
-    {
-        /**
-         * @brief operator ()
-         * @param x the address of which calculate the hash
-         * @return the hash of x
-         *
-         * Should this method go in address.h?
-         *
-         * It calculates the hash taking the uint32_t hash value of the ipv4 address.
-         * It works only for InetSocketAddresses (Ipv4 version)
-         */
-        size_t operator()(const Address& x) const
-        {
-            NS_ABORT_IF(!InetSocketAddress::IsMatchingType(x));
-            InetSocketAddress a = InetSocketAddress::ConvertFrom(x);
-            return std::hash<uint32_t>()(a.GetIpv4().Get());
-        }
-    };
-
-    std::unordered_map<Address, BurstHandler, AddressHash>
-        m_burstHandlerMap; //!< Map of BurstHandlers, assuming a user only has one data stream
+    FlowTable m_flowHandlerMap;   //!< Map of FlowHandlers, one for each source address and port
+    std::list<FlowKey> m_flowLru; //!< Flows from the most to the least recently active
 
     // In the case of TCP, each socket accept returns a new socket, so the
     // listening socket is stored separately from the accepted sockets
-    Ptr<Socket> m_socket{0};             //!< Listening socket
-    std::list<Ptr<Socket>> m_socketList; //!< the accepted sockets
-    Address m_local;                     //!< Local address to bind to
-    TypeId m_tid;                        //!< Protocol TypeId
-    uint64_t m_totRxBursts{0};           //!< Total bursts received
-    uint64_t m_totRxFragments{0};        //!< Total fragments received
-    uint64_t m_totRxBytes{0};            //!< Total bytes received
+    Ptr<Socket> m_socket{0};               //!< Listening socket
+    std::list<Ptr<Socket>> m_socketList;   //!< the accepted sockets
+    Address m_local;                       //!< Local address to bind to
+    TypeId m_tid;                          //!< Protocol TypeId
+    uint64_t m_totRxBursts{0};             //!< Total bursts received
+    uint64_t m_totRxFragments{0};          //!< Total fragments received
+    uint64_t m_totRxBytes{0};              //!< Total bytes received
+    uint64_t m_totFecRecoveredBursts{0};   //!< Total bursts received after FEC recovery
+    uint32_t m_reassemblyWindow{1};        //!< Number of bursts concurrently reassembled per flow
+    ReassemblyMode m_reassemblyMode{Auto}; //!< How received bursts are reassembled
+    Time m_reassemblyTimeout{Seconds(0)};  //!< Maximum time to complete a burst, if positive
+    Time m_nackInterval{Seconds(0)};       //!< Inactivity before sending a NACK, if positive
+    uint32_t m_maxNackRounds{3};           //!< Maximum number of NACKs sent per burst
+    Time m_feedbackInterval{Seconds(0)};   //!< Interval between reception reports, if positive
+    EventId m_feedbackEvent;               //!< Event id for the next reception report
+    uint32_t m_maxFlows{0};                //!< Maximum number of flows, if positive
+    Time m_flowIdleTimeout{Seconds(0)};    //!< Inactivity before evicting a flow, if positive
+    EventId m_idleEvictionEvent;           //!< Event id for the next idle flow eviction
+    uint64_t m_totEvictedFlows{0};         //!< Total flows evicted
+    Time m_playoutDelay{Seconds(0)};       //!< Target delay of the playout stage, if positive
+    double m_playoutFrameRate{60};         //!< Vsync rate of the playout stage [FPS]
+    uint64_t m_totDisplayedFrames{0};      //!< Total frames displayed
+    uint64_t m_totLateFrames{0};           //!< Total frames displayed after their target vsync
+    uint64_t m_totSkippedFrames{0};        //!< Total frames skipped
+    uint64_t m_totPlayoutStalls{0};        //!< Total playout stalls
+
+    /// Serialization format of the fragment headers
+    SeqTsSizeFragHeader::Format m_headerFormat{SeqTsSizeFragHeader::Full};
+    /// Deframers of the accepted stream sockets, splitting the byte streams into fragments
+    std::map<Ptr<Socket>, BurstStreamDeframer> m_deframers;
 
     // Traced Callback
     /// Callback for tracing the fragment Rx events, includes source, destination addresses, and
@@ -219,6 +663,24 @@ class BurstSink : public Application
     /// headers
     TracedCallback<Ptr<const Packet>, const Address&, const Address&, const SeqTsSizeFragHeader&>
         m_rxBurstTrace;
+    /// Callbacks for tracing incomplete bursts being discarded
+    TracedCallback<const Address&, const Address&, const SeqTsSizeFragHeader&, double, double>
+        m_rxPartialBurstTrace;
+    /// Callbacks for tracing the NACKs sent
+    TracedCallback<const Address&, const BurstNackHeader&> m_txNackTrace;
+    /// Callbacks for tracing the bursts completed after sending NACKs
+    TracedCallback<const Address&, const Address&, const SeqTsSizeFragHeader&, uint32_t, Time>
+        m_recoveredBurstTrace;
+    /// Callbacks for tracing the reception reports sent
+    TracedCallback<const Address&, const BurstFeedbackHeader&> m_txFeedbackTrace;
+    /// Callbacks for tracing the flows evicted from the flow table
+    TracedCallback<const Address&, Time> m_flowEvictedTrace;
+    /// Callbacks for tracing the frames displayed by the playout stage
+    TracedCallback<const Address&, const SeqTsSizeFragHeader&, Time, Time> m_frameDisplayedTrace;
+    /// Callbacks for tracing the frames skipped by the playout stage
+    TracedCallback<const Address&, const SeqTsSizeFragHeader&> m_frameSkippedTrace;
+    /// Callbacks for tracing the playout stalls
+    TracedCallback<const Address&, Time> m_playoutStallTrace;
 };
 
 } // namespace ns3
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-stream-deframer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstStreamDeframer");
+
+NS_OBJECT_ENSURE_REGISTERED(BurstStreamHeader);
+
+BurstStreamHeader::BurstStreamHeader(uint32_t length)
+    : m_length(length)
+{
+    NS_LOG_FUNCTION(this << length);
+}
+
+TypeId
+BurstStreamHeader::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::BurstStreamHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<BurstStreamHeader>();
+    return tid;
+}
+
+TypeId
+BurstStreamHeader::GetInstanceTypeId(void) const
+{
+    return GetTypeId();
+}
+
+void
+BurstStreamHeader::SetLength(uint32_t length)
+{
+    m_length = length;
+}
+
+uint32_t
+BurstStreamHeader::GetLength(void) const
+{
+    return m_length;
+}
+
+void
+BurstStreamHeader::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    os << "(length=" << m_length << ")";
+}
+
+uint32_t
+BurstStreamHeader::GetSerializedSize(void) const
+{
+    return SERIALIZED_SIZE;
+}
+
+void
+BurstStreamHeader::Serialize(Buffer::Iterator start) const
+{
+    NS_LOG_FUNCTION(this << &start);
+    start.WriteHtonU32(m_length);
+}
+
+uint32_t
+BurstStreamHeader::Deserialize(Buffer::Iterator start)
+{
+    NS_LOG_FUNCTION(this << &start);
+    m_length = start.ReadNtohU32();
+    return GetSerializedSize();
+}
+
+BurstStreamDeframer::BurstStreamDeframer()
+    : m_offset(0),
+      m_bufferedBytes(0),
+      m_fragmentSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BurstStreamDeframer::Push(Ptr<Packet> data)
+{
+    NS_LOG_FUNCTION(this << data);
+    if (data->GetSize() == 0)
+    {
+        return;
+    }
+    m_chunks.push_back(data);
+    m_bufferedBytes += data->GetSize();
+}
+
+Ptr<Packet>
+BurstStreamDeframer::Pop(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_fragmentSize == 0)
+    {
+        // the length prefix may itself span several reads
+        if (m_bufferedBytes < BurstStreamHeader::SERIALIZED_SIZE)
+        {
+            return nullptr;
+        }
+        BurstStreamHeader streamHeader;
+        Consume(BurstStreamHeader::SERIALIZED_SIZE)->RemoveHeader(streamHeader);
+        m_fragmentSize = streamHeader.GetLength();
+        NS_ABORT_MSG_IF(m_fragmentSize == 0, "Empty fragment in the stream: framing lost");
+    }
+
+    if (m_bufferedBytes < m_fragmentSize)
+    {
+        NS_LOG_LOGIC("Waiting for " << m_fragmentSize - m_bufferedBytes
+                                    << " more bytes of the fragment");
+        return nullptr;
+    }
+
+    Ptr<Packet> fragment = Consume(m_fragmentSize);
+    m_fragmentSize = 0;
+    return fragment;
+}
+
+uint64_t
+BurstStreamDeframer::GetBufferedBytes(void) const
+{
+    return m_bufferedBytes;
+}
+
+Ptr<Packet>
+BurstStreamDeframer::Consume(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    NS_ASSERT(size <= m_bufferedBytes);
+
+    Ptr<Packet> data;
+    while (size > 0)
+    {
+        Ptr<Packet> chunk = m_chunks.front();
+        uint32_t chunkSize = chunk->GetSize();
+        uint32_t partSize = std::min(size, chunkSize - m_offset);
+
+        // whole chunks are used as they are, otherwise they share their buffer with the part
+        Ptr<Packet> part = chunk;
+        if (m_offset > 0 || partSize < chunkSize)
+        {
+            part = chunk->CreateFragment(m_offset, partSize);
+        }
+        if (data)
+        {
+            data->AddAtEnd(part);
+        }
+        else
+        {
+            data = part;
+        }
+
+        m_offset += partSize;
+        if (m_offset == chunkSize)
+        {
+            m_chunks.pop_front();
+            m_offset = 0;
+        }
+        size -= partSize;
+        m_bufferedBytes -= partSize;
+    }
+    return data;
+}
+
+} // namespace ns3
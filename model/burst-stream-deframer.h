@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_STREAM_DEFRAMER_H
+#define BURST_STREAM_DEFRAMER_H
+
+#include "ns3/header.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <deque>
+
+namespace ns3
+{
+
+/**
+ * @ingroup applications
+ * @brief Length prefix of a fragment sent over a byte stream
+ *
+ * Byte streams, e.g., TCP, do not preserve the boundaries of the fragments
+ * sent by a BurstyApplication: each fragment is preceded by its size,
+ * fragment header included, so that the BurstSink can split the stream
+ * back into fragments with a BurstStreamDeframer.
+ */
+class BurstStreamHeader : public Header
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+
+    /**
+     * @brief constructor
+     * @param length the size of the fragment following the header [B]
+     */
+    BurstStreamHeader(uint32_t length = 0);
+
+    /**
+     * @brief Set the size of the fragment following the header
+     * @param length the size of the fragment [B]
+     */
+    void SetLength(uint32_t length);
+
+    /**
+     * @brief Get the size of the fragment following the header
+     * @return the size of the fragment [B]
+     */
+    uint32_t GetLength(void) const;
+
+    /// The serialized size of the header [B]
+    static const uint32_t SERIALIZED_SIZE = 4;
+
+    // Inherited
+    virtual TypeId GetInstanceTypeId(void) const override;
+    virtual void Print(std::ostream& os) const override;
+    virtual uint32_t GetSerializedSize(void) const override;
+    virtual void Serialize(Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(Buffer::Iterator start) override;
+
+  private:
+    uint32_t m_length; //!< The size of the fragment following the header
+};
+
+/**
+ * @ingroup burstsink
+ *
+ * @brief Splits a byte stream back into the fragments of a BurstyApplication
+ *
+ * Each read of a stream socket may carry part of a fragment, or several
+ * fragments. The received packets are kept in a queue of chunks, and
+ * fragments are parsed from the head of the stream upon their
+ * BurstStreamHeader, across chunk boundaries. Fragments are built from
+ * fragments of the received packets, sharing their buffers, so that the
+ * payload is not copied unless a fragment spans several reads.
+ */
+class BurstStreamDeframer
+{
+  public:
+    BurstStreamDeframer();
+
+    /**
+     * @brief Append the data read from the stream
+     * @param data the packet read from the socket
+     */
+    void Push(Ptr<Packet> data);
+
+    /**
+     * @brief Extract the next complete fragment from the head of the stream
+     * @return the fragment, without its BurstStreamHeader, or nullptr if not yet received
+     */
+    Ptr<Packet> Pop(void);
+
+    /**
+     * @brief Get the number of bytes received and not yet extracted
+     * @return the number of buffered bytes [B]
+     */
+    uint64_t GetBufferedBytes(void) const;
+
+  private:
+    /**
+     * @brief Remove bytes from the head of the stream
+     * @param size the number of bytes to remove, at most the buffered ones
+     * @return the bytes removed
+     */
+    Ptr<Packet> Consume(uint32_t size);
+
+    std::deque<Ptr<Packet>> m_chunks; //!< Packets read and not yet consumed, oldest first
+    uint32_t m_offset;                //!< Bytes already consumed from the oldest packet
+    uint64_t m_bufferedBytes;         //!< Bytes read and not yet consumed
+    uint32_t m_fragmentSize;          //!< Size of the fragment at the head, 0 if not parsed yet
+};
+
+} // namespace ns3
+
+#endif /* BURST_STREAM_DEFRAMER_H */
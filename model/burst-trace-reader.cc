@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-trace-reader.h"
+
+#include "ns3/abort.h"
+#include "ns3/csv-reader.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstTraceReader");
+
+BurstTraceReader::BurstTraceReader(const std::string& path,
+                                   uint32_t chunkSize,
+                                   double prefetchThreshold)
+    : m_path(path),
+      m_chunkSize(chunkSize)
+{
+    NS_LOG_FUNCTION(this << path << chunkSize << prefetchThreshold);
+    NS_ABORT_MSG_IF(chunkSize == 0, "Chunks should hold at least one burst");
+    NS_ABORT_MSG_IF(prefetchThreshold < 0 || prefetchThreshold > 1,
+                    "The prefetch threshold should be in [0, 1], instead found "
+                        << prefetchThreshold);
+    m_prefetchPosition = std::ceil(prefetchThreshold * chunkSize);
+
+    m_file.open(path, std::ios::binary);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Can't open trace file " << path);
+    m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+    if (m_file.gcount() == sizeof(m_header) && m_header.HasMagic())
+    {
+        NS_ABORT_MSG_IF(!m_header.IsValid(),
+                        "Unsupported version, byte order or array widths of binary trace "
+                            << path);
+    }
+    else
+    {
+        // not a binary trace: the file is read as CSV from its beginning
+        m_file.clear();
+        m_file.seekg(0);
+        m_header.Reset();
+        m_isCsv = true;
+    }
+
+    SetCurrent(ReadChunk());
+}
+
+BurstTraceReader::~BurstTraceReader()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_next.valid())
+    {
+        // the prefetching thread is still using the file
+        m_next.wait();
+    }
+}
+
+bool
+BurstTraceReader::HasNext(void)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_position < m_current.size())
+    {
+        return true;
+    }
+
+    // the current chunk is exhausted: wait for the next one, if any
+    Prefetch();
+    if (!m_next.valid())
+    {
+        return false;
+    }
+    SetCurrent(m_next.get());
+    NS_LOG_LOGIC("Switched to a chunk of " << m_current.size() << " bursts");
+    return !m_current.empty();
+}
+
+BurstTraceReader::Burst
+BurstTraceReader::Next(void)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!HasNext(),
+                    "All bursts from the trace have already been read, "
+                    "you should have checked if HasNext");
+
+    Burst burst = m_current[m_position++];
+    if (m_position >= m_prefetchPosition)
+    {
+        Prefetch();
+    }
+    return burst;
+}
+
+uint64_t
+BurstTraceReader::GetBufferedBursts(void) const
+{
+    // the size of a chunk being read is not known yet
+    return m_current.size() - m_position + (m_next.valid() ? m_chunkSize : 0);
+}
+
+Time
+BurstTraceReader::GetDuration(void) const
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_isCsv)
+    {
+        return NanoSeconds(m_header.m_duration);
+    }
+    if (m_hasDuration)
+    {
+        return m_duration;
+    }
+
+    CsvReader csv(m_path);
+    Time duration;
+    uint64_t size;
+    Time period;
+    uint8_t importance;
+    while (csv.FetchNextRow())
+    {
+        if (!csv.IsBlankRow())
+        {
+            BurstTraceStore::ParseCsvRow(csv, m_path, size, period, importance);
+            duration += period;
+        }
+    }
+    m_duration = duration;
+    m_hasDuration = true;
+    return duration;
+}
+
+BurstTraceReader::Chunk
+BurstTraceReader::ReadChunk(void)
+{
+    // no ns-3 code, not even logging, as this may run in the prefetching thread
+    Chunk chunk;
+    chunk.m_bursts.reserve(m_chunkSize);
+
+    if (m_isCsv)
+    {
+        std::string line;
+        RawBurst burst;
+        while (chunk.m_bursts.size() < m_chunkSize && std::getline(m_file, line))
+        {
+            m_csvLine++;
+            if (ParseCsvLine(line, burst, chunk.m_error))
+            {
+                chunk.m_bursts.push_back(burst);
+            }
+            else if (!chunk.m_error.empty())
+            {
+                break;
+            }
+        }
+        return chunk;
+    }
+
+    // binary traces: each array is read from its own offset in the file
+    uint64_t count = std::min<uint64_t>(m_chunkSize, m_header.m_nBursts - m_nextIndex);
+    uint32_t sizeWidth = m_header.m_sizeWidth;
+    uint32_t periodWidth = m_header.m_periodWidth;
+    std::vector<uint8_t> sizes(count * sizeWidth);
+    std::vector<uint8_t> periods(count * periodWidth);
+    std::vector<uint8_t> importance(count, 0);
+
+    m_file.seekg(m_header.GetSizesOffset() + m_nextIndex * sizeWidth);
+    m_file.read(reinterpret_cast<char*>(sizes.data()), sizes.size());
+    m_file.seekg(m_header.GetPeriodsOffset() + m_nextIndex * periodWidth);
+    m_file.read(reinterpret_cast<char*>(periods.data()), periods.size());
+    if (m_header.m_flags & BurstTraceFileHeader::HAS_IMPORTANCE)
+    {
+        m_file.seekg(m_header.GetImportanceOffset() + m_nextIndex);
+        m_file.read(reinterpret_cast<char*>(importance.data()), importance.size());
+    }
+    if (!m_file)
+    {
+        chunk.m_error = "Truncated binary trace " + m_path;
+        return chunk;
+    }
+
+    for (uint64_t index = 0; index < count; index++)
+    {
+        chunk.m_bursts.push_back(
+            {BurstTrace::ReadPacked(sizes.data(), sizeWidth, index),
+             static_cast<int64_t>(BurstTrace::ReadPacked(periods.data(), periodWidth, index)),
+             importance[index]});
+    }
+    m_nextIndex += count;
+    return chunk;
+}
+
+bool
+BurstTraceReader::ParseCsvLine(const std::string& line, RawBurst& burst, std::string& error) const
+{
+    // Split the line into its trimmed fields, ignoring comments and blank lines
+    std::vector<std::string> fields;
+    std::istringstream stream(line.substr(0, line.find('#')));
+    std::string field;
+    while (std::getline(stream, field, ','))
+    {
+        std::size_t begin = field.find_first_not_of(" \t\r");
+        std::size_t end = field.find_last_not_of(" \t\r");
+        fields.push_back(begin == std::string::npos ? "" : field.substr(begin, end - begin + 1));
+    }
+    if (fields.empty() || (fields.size() == 1 && fields[0].empty()))
+    {
+        return false;
+    }
+
+    // Expecting burst size and period to next burst
+    std::ostringstream oss;
+    char* end = nullptr;
+    errno = 0;
+    bool ok = fields.size() >= 2 && !fields[0].empty() && fields[0][0] != '-';
+    burst.m_size = ok ? std::strtoull(fields[0].c_str(), &end, 10) : 0;
+    ok = ok && *end == '\0' && !fields[1].empty();
+    double seconds = ok ? std::strtod(fields[1].c_str(), &end) : 0;
+    ok = ok && *end == '\0' && errno == 0;
+    if (!ok)
+    {
+        oss << "Something went wrong on line " << m_csvLine << " of file " << m_path;
+        error = oss.str();
+        return false;
+    }
+    if (seconds < 0)
+    {
+        oss << "Period to next burst should be non-negative, instead found: " << seconds
+            << " on line " << m_csvLine;
+        error = oss.str();
+        return false;
+    }
+    // rounded to the nanosecond, as Seconds does with the default resolution
+    burst.m_period = std::llround(seconds * 1e9);
+
+    // The importance class is optional
+    unsigned long importanceClass = 0;
+    if (fields.size() > 2)
+    {
+        ok = !fields[2].empty() && fields[2][0] != '-';
+        importanceClass = ok ? std::strtoul(fields[2].c_str(), &end, 10) : 0;
+        if (!ok || *end != '\0' || errno != 0 || importanceClass > 255)
+        {
+            oss << "Invalid importance class on line " << m_csvLine << " of file " << m_path;
+            error = oss.str();
+            return false;
+        }
+    }
+    burst.m_importance = importanceClass;
+    return true;
+}
+
+void
+BurstTraceReader::SetCurrent(Chunk chunk)
+{
+    NS_LOG_FUNCTION(this << chunk.m_bursts.size());
+    NS_ABORT_MSG_IF(!chunk.m_error.empty(), chunk.m_error);
+
+    // periods are only built here, in the main thread
+    m_current.clear();
+    m_current.reserve(chunk.m_bursts.size());
+    for (const auto& burst : chunk.m_bursts)
+    {
+        m_current.push_back({burst.m_size, NanoSeconds(burst.m_period), burst.m_importance});
+    }
+    m_position = 0;
+    m_endOfTrace = m_current.size() < m_chunkSize;
+    if (m_prefetchPosition == 0)
+    {
+        Prefetch();
+    }
+}
+
+void
+BurstTraceReader::Prefetch(void)
+{
+    if (m_next.valid() || m_endOfTrace)
+    {
+        return;
+    }
+    NS_LOG_LOGIC("Prefetching the next chunk after " << m_position << " bursts");
+    m_next = std::async(std::launch::async, &BurstTraceReader::ReadChunk, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_TRACE_READER_H
+#define BURST_TRACE_READER_H
+
+#include "burst-trace-store.h"
+
+#include "ns3/nstime.h"
+
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup applications
+ *
+ * @brief Streams a burst trace file in chunks of bursts, with bounded lookahead
+ *
+ * Unlike the BurstTraceStore, which holds whole traces, the reader only
+ * holds two chunks of bursts: the chunk being consumed and the next one.
+ * Once the bursts consumed from the current chunk exceed a threshold, the
+ * next chunk is read in a background thread, so that it is usually ready
+ * when the current one is exhausted. The memory held is thus constant
+ * regardless of the length of the trace, and the first burst is available
+ * after reading the first chunk only.
+ *
+ * Both CSV and binary trace files are accepted. The file is only accessed
+ * by the prefetching thread while a chunk is being read, and no ns-3 code
+ * runs in that thread: CSV rows are parsed with the standard library, and
+ * the bursts read are kept as plain integers until their chunk becomes the
+ * current one in the main thread. Malformed rows are reported along with
+ * the chunk, and the simulation is aborted from the main thread once the
+ * chunk is needed.
+ */
+class BurstTraceReader
+{
+  public:
+    /**
+     * @brief A burst of the trace
+     */
+    struct Burst
+    {
+        uint64_t m_size;      //!< The size of the burst [B]
+        Time m_period;        //!< The period to the next burst
+        uint8_t m_importance; //!< The importance class of the burst
+    };
+
+    /**
+     * @brief constructor, reading the first chunk
+     * @param path the path of the trace file, either CSV or binary
+     * @param chunkSize the number of bursts per chunk
+     * @param prefetchThreshold the fraction of the current chunk to consume
+     * before reading the next one, in [0, 1]
+     */
+    BurstTraceReader(const std::string& path, uint32_t chunkSize, double prefetchThreshold);
+    ~BurstTraceReader();
+
+    /**
+     * @brief Check whether more bursts are present in the trace
+     * @return false when the end of the trace is reached
+     */
+    bool HasNext(void);
+
+    /**
+     * @brief Get the next burst of the trace
+     * @return the next burst
+     */
+    Burst Next(void);
+
+    /**
+     * @brief Get the number of bursts held in memory
+     * @return the number of bursts of the current and of the next chunk
+     */
+    uint64_t GetBufferedBursts(void) const;
+
+    /**
+     * @brief Get the duration of the whole trace
+     *
+     * The duration is read from the header of binary traces, while CSV traces
+     * are scanned once more upon the first call, without storing them, and
+     * the duration is cached.
+     * @return the sum of the periods of all bursts
+     */
+    Time GetDuration(void) const;
+
+  private:
+    /**
+     * @brief A burst as read from the trace file, before building its period
+     */
+    struct RawBurst
+    {
+        uint64_t m_size;      //!< The size of the burst [B]
+        int64_t m_period;     //!< The period to the next burst [ns]
+        uint8_t m_importance; //!< The importance class of the burst
+    };
+
+    /**
+     * @brief A chunk of bursts read from the trace file
+     */
+    struct Chunk
+    {
+        std::vector<RawBurst> m_bursts; //!< The bursts read, fewer than a chunk at the end
+        std::string m_error;            //!< The error found while reading, empty if none
+    };
+
+    /**
+     * @brief Read the next chunk from the trace file, possibly in the prefetching thread
+     *
+     * Only the standard library is used here. Errors are not fatal either,
+     * as aborting the prefetching thread would terminate the simulation
+     * without any message.
+     * @return the chunk read
+     */
+    Chunk ReadChunk(void);
+
+    /**
+     * @brief Parse a line of a CSV trace file, with the standard library only
+     * @param line the line, possibly with a trailing comment
+     * @param burst the burst parsed, unless the line is blank
+     * @param error the description of the error, if malformed
+     * @return false if the line is blank or malformed
+     */
+    bool ParseCsvLine(const std::string& line, RawBurst& burst, std::string& error) const;
+
+    /**
+     * @brief Make a chunk read from the trace file the current one, aborting
+     * upon its errors
+     * @param chunk the chunk read
+     */
+    void SetCurrent(Chunk chunk);
+
+    /**
+     * @brief Start reading the next chunk in the background, unless already
+     * started or at the end of the trace
+     */
+    void Prefetch(void);
+
+    std::string m_path;                  //!< The path of the trace file
+    uint32_t m_chunkSize;                //!< The number of bursts per chunk
+    uint32_t m_prefetchPosition;         //!< Position in the chunk triggering the prefetch
+    bool m_isCsv{false};                 //!< Whether the trace file is a CSV one
+    std::ifstream m_file;                //!< The trace file
+    uint64_t m_csvLine{0};               //!< The number of lines read from a CSV trace
+    BurstTraceFileHeader m_header;       //!< The header of the binary trace
+    uint64_t m_nextIndex{0};             //!< Position in the trace of the next burst to read
+    bool m_endOfTrace{false};            //!< True once the last chunk has been read
+    std::vector<Burst> m_current;        //!< The chunk being consumed
+    std::size_t m_position{0};           //!< Position in the current chunk of the next burst
+    mutable Time m_duration{};           //!< The duration of the trace, once known
+    mutable bool m_hasDuration{false};   //!< Whether the duration of the trace is known
+
+    /// The next chunk, possibly being read by the prefetching thread
+    std::future<Chunk> m_next;
+};
+
+} // namespace ns3
+
+#endif /* BURST_TRACE_READER_H */
@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "burst-trace-store.h"
+
+#include "ns3/abort.h"
+#include "ns3/csv-reader.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BURST_TRACE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BurstTraceStore");
+
+static const char TRACE_MAGIC[8] = {'B', 'U', 'R', 'S', 'T', 'T', 'R', 'C'};
+
+/**
+ * @brief Round a size up to a multiple of 8 bytes
+ * @param size the size [B]
+ * @return the padded size [B]
+ */
+static uint64_t
+PadTo8(uint64_t size)
+{
+    return (size + 7) & ~uint64_t(7);
+}
+
+/**
+ * @brief Write an integer into a packed array
+ * @param array the packed array
+ * @param width the size of each element, either 4 or 8 bytes
+ * @param index the position of the element
+ * @param value the element, fitting the width
+ */
+static void
+WritePacked(uint8_t* array, uint32_t width, uint64_t index, uint64_t value)
+{
+    if (width == 4)
+    {
+        uint32_t packed = value;
+        std::memcpy(array + index * 4, &packed, sizeof(packed));
+        return;
+    }
+    std::memcpy(array + index * 8, &value, sizeof(value));
+}
+
+/**
+ * @brief Get the value of a comment line of a CSV trace, if it carries the given key
+ * @param line the comment line
+ * @param key the key, e.g., "Frame rate:"
+ * @param value the text following the key, without leading spaces
+ * @return true if the line carries the key
+ */
+static bool
+GetCommentValue(const std::string& line, const std::string& key, std::string& value)
+{
+    std::size_t pos = line.find(key);
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    pos = line.find_first_not_of(' ', pos + key.size());
+    value = pos == std::string::npos ? "" : line.substr(pos);
+    return true;
+}
+
+void
+BurstTraceFileHeader::Reset(void)
+{
+    std::memset(this, 0, sizeof(*this));
+    std::memcpy(m_magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    m_version = VERSION;
+    m_sizeWidth = 4;
+    m_periodWidth = 4;
+}
+
+bool
+BurstTraceFileHeader::HasMagic(void) const
+{
+    return std::memcmp(m_magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0;
+}
+
+bool
+BurstTraceFileHeader::IsValid(void) const
+{
+    // a different byte order shows up as a different version
+    return HasMagic() && m_version == VERSION && (m_sizeWidth == 4 || m_sizeWidth == 8) &&
+           (m_periodWidth == 4 || m_periodWidth == 8);
+}
+
+uint64_t
+BurstTraceFileHeader::GetSizesOffset(void) const
+{
+    return sizeof(BurstTraceFileHeader);
+}
+
+uint64_t
+BurstTraceFileHeader::GetPeriodsOffset(void) const
+{
+    return GetSizesOffset() + PadTo8(m_nBursts * m_sizeWidth);
+}
+
+uint64_t
+BurstTraceFileHeader::GetImportanceOffset(void) const
+{
+    return GetPeriodsOffset() + PadTo8(m_nBursts * m_periodWidth);
+}
+
+uint64_t
+BurstTraceFileHeader::GetFileSize(void) const
+{
+    return GetImportanceOffset() + (m_flags & HAS_IMPORTANCE ? m_nBursts : 0);
+}
+
+BurstTrace::BurstTrace(const std::string& path)
+    : m_path(path)
+{
+    NS_LOG_FUNCTION(this << path);
+    m_header.Reset();
+}
+
+BurstTrace::~BurstTrace()
+{
+    NS_LOG_FUNCTION(this);
+#ifdef BURST_TRACE_MMAP
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_length);
+    }
+#endif
+}
+
+const std::string&
+BurstTrace::GetPath(void) const
+{
+    return m_path;
+}
+
+std::string
+BurstTrace::GetAppName(void) const
+{
+    return m_header.m_appName;
+}
+
+double
+BurstTrace::GetFrameRate(void) const
+{
+    return m_header.m_frameRate;
+}
+
+double
+BurstTrace::GetDataRate(void) const
+{
+    return m_header.m_dataRate;
+}
+
+Time
+BurstTrace::GetDuration(void) const
+{
+    return NanoSeconds(m_header.m_duration);
+}
+
+uint64_t
+BurstTrace::GetNBursts(void) const
+{
+    return m_header.m_nBursts;
+}
+
+uint64_t
+BurstTrace::GetBurstSize(uint64_t index) const
+{
+    NS_ASSERT(index < m_header.m_nBursts);
+    return ReadPacked(m_sizes, m_header.m_sizeWidth, index);
+}
+
+Time
+BurstTrace::GetPeriod(uint64_t index) const
+{
+    NS_ASSERT(index < m_header.m_nBursts);
+    return NanoSeconds(ReadPacked(m_periods, m_header.m_periodWidth, index));
+}
+
+Time
+BurstTrace::GetBurstStart(uint64_t index) const
+{
+    NS_ASSERT(index < m_starts.size());
+    return NanoSeconds(m_starts[index]);
+}
+
+uint64_t
+BurstTrace::FindBurst(Time time) const
+{
+    NS_LOG_FUNCTION(this << time);
+    if (!time.IsStrictlyPositive())
+    {
+        return 0;
+    }
+    // the duration, at the end of the prefix sum, is not a burst
+    auto it = std::lower_bound(m_starts.begin(), m_starts.end() - 1, time.GetNanoSeconds());
+    return it - m_starts.begin();
+}
+
+uint8_t
+BurstTrace::GetImportance(uint64_t index) const
+{
+    NS_ASSERT(index < m_header.m_nBursts);
+    return m_importance ? m_importance[index] : 0;
+}
+
+uint64_t
+BurstTrace::GetMemoryUsage(void) const
+{
+    return sizeof(*this) + m_image.capacity() + m_starts.capacity() * sizeof(uint64_t);
+}
+
+bool
+BurstTrace::IsMapped(void) const
+{
+    return m_mapping != nullptr;
+}
+
+void
+BurstTrace::Save(const std::string& path) const
+{
+    NS_LOG_FUNCTION(this << path);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can't open file " << path);
+    file.write(reinterpret_cast<const char*>(m_data), m_length);
+    NS_ABORT_MSG_IF(!file, "Can't write trace file " << path);
+}
+
+void
+BurstTrace::Attach(const uint8_t* data, uint64_t length)
+{
+    NS_LOG_FUNCTION(this << length);
+
+    NS_ABORT_MSG_IF(length < sizeof(BurstTraceFileHeader), "Not a binary burst trace: " << m_path);
+    std::memcpy(&m_header, data, sizeof(m_header));
+    NS_ABORT_MSG_IF(!m_header.HasMagic(), "Not a binary burst trace: " << m_path);
+    NS_ABORT_MSG_IF(!m_header.IsValid(),
+                    "Unsupported version, byte order or array widths of binary trace " << m_path);
+    uint64_t nBursts = m_header.m_nBursts;
+    NS_ABORT_MSG_IF(nBursts > length / (m_header.m_sizeWidth + m_header.m_periodWidth) ||
+                        length < m_header.GetFileSize(),
+                    "Truncated binary trace " << m_path);
+
+    m_header.m_appName[sizeof(m_header.m_appName) - 1] = '\0';
+    m_data = data;
+    m_length = length;
+    m_sizes = data + m_header.GetSizesOffset();
+    m_periods = data + m_header.GetPeriodsOffset();
+    bool hasImportance = m_header.m_flags & BurstTraceFileHeader::HAS_IMPORTANCE;
+    m_importance = hasImportance ? data + m_header.GetImportanceOffset() : nullptr;
+
+    m_starts.resize(nBursts + 1);
+    m_starts[0] = 0;
+    for (uint64_t index = 0; index < nBursts; index++)
+    {
+        uint64_t period = ReadPacked(m_periods, m_header.m_periodWidth, index);
+        m_starts[index + 1] = m_starts[index] + period;
+    }
+    NS_ABORT_MSG_IF(m_starts.back() != m_header.m_duration,
+                    "The duration does not match the periods in binary trace " << m_path);
+}
+
+uint64_t
+BurstTrace::ReadPacked(const uint8_t* array, uint32_t width, uint64_t index)
+{
+    // arrays are read bytewise, not to rely on the alignment of the image
+    if (width == 4)
+    {
+        uint32_t value;
+        std::memcpy(&value, array + index * 4, sizeof(value));
+        return value;
+    }
+    uint64_t value;
+    std::memcpy(&value, array + index * 8, sizeof(value));
+    return value;
+}
+
+Ptr<const BurstTrace>
+BurstTraceStore::Get(const std::string& path)
+{
+    NS_LOG_FUNCTION(path);
+
+    auto& traces = GetTraces();
+    auto it = traces.find(path);
+    if (it != traces.end())
+    {
+        NS_LOG_LOGIC("Trace " << path << " already cached");
+        return it->second;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can't open trace file " << path);
+    BurstTraceFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool isBinary = file.gcount() == sizeof(header) && header.HasMagic();
+    file.close();
+
+    Ptr<BurstTrace> trace = isBinary ? MapBinary(path) : ImportCsv(path);
+    traces.emplace(path, trace);
+    return trace;
+}
+
+void
+BurstTraceStore::Purge(void)
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    auto& traces = GetTraces();
+    for (auto it = traces.begin(); it != traces.end();)
+    {
+        // the store holds the only reference left
+        if (it->second->GetReferenceCount() == 1)
+        {
+            NS_LOG_LOGIC("Releasing trace " << it->first);
+            it = traces.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+uint32_t
+BurstTraceStore::GetNTraces(void)
+{
+    return GetTraces().size();
+}
+
+void
+BurstTraceStore::ParseCsvRow(const CsvReader& csv,
+                             const std::string& path,
+                             uint64_t& size,
+                             Time& period,
+                             uint8_t& importance)
+{
+    // Expecting burst size and period to next burst
+    double seconds;
+    bool ok = csv.GetValue(0, size);
+    ok |= csv.GetValue(1, seconds);
+    NS_ABORT_MSG_IF(!ok,
+                    "Something went wrong on line " << csv.RowNumber() << " of file " << path);
+    NS_ABORT_MSG_IF(seconds < 0,
+                    "Period to next burst should be non-negative, instead found: "
+                        << seconds << " on line " << csv.RowNumber());
+    period = Seconds(seconds);
+
+    // The importance class is optional
+    uint32_t importanceClass = 0;
+    if (csv.ColumnCount() > 2)
+    {
+        NS_ABORT_MSG_IF(!csv.GetValue(2, importanceClass) || importanceClass > 255,
+                        "Invalid importance class on line " << csv.RowNumber() << " of file "
+                                                            << path);
+    }
+    importance = importanceClass;
+}
+
+std::map<std::string, Ptr<BurstTrace>>&
+BurstTraceStore::GetTraces(void)
+{
+    static std::map<std::string, Ptr<BurstTrace>> traces;
+    return traces;
+}
+
+Ptr<BurstTrace>
+BurstTraceStore::MapBinary(const std::string& path)
+{
+    NS_LOG_FUNCTION(path);
+
+    Ptr<BurstTrace> trace = Ptr<BurstTrace>(new BurstTrace(path), false);
+#ifdef BURST_TRACE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "Can't open trace file " << path);
+    struct stat status;
+    NS_ABORT_MSG_IF(fstat(fd, &status) != 0, "Can't stat trace file " << path);
+    uint64_t length = status.st_size;
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(mapping == MAP_FAILED, "Can't map trace file " << path);
+
+    trace->m_mapping = mapping;
+    trace->m_length = length;
+    trace->Attach(static_cast<const uint8_t*>(mapping), length);
+#else
+    // without mmap, the binary image is read at once
+    std::ifstream file(path, std::ios::binary);
+    trace->m_image.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    trace->Attach(trace->m_image.data(), trace->m_image.size());
+#endif
+
+    NS_LOG_INFO("Mapped " << trace->GetNBursts() << " bursts from file " << path);
+    return trace;
+}
+
+Ptr<BurstTrace>
+BurstTraceStore::ImportCsv(const std::string& path)
+{
+    NS_LOG_FUNCTION(path);
+
+    BurstTraceFileHeader header;
+    header.Reset();
+
+    // the metadata of the traced application is carried by the leading comments
+    std::ifstream file(path);
+    std::string line;
+    std::string value;
+    while (std::getline(file, line) && (line.empty() || line[0] == '#'))
+    {
+        if (GetCommentValue(line, "Application:", value))
+        {
+            std::strncpy(header.m_appName, value.c_str(), sizeof(header.m_appName) - 1);
+        }
+        else if (GetCommentValue(line, "Frame rate:", value))
+        {
+            std::istringstream(value) >> header.m_frameRate;
+        }
+        else if (GetCommentValue(line, "Data rate:", value))
+        {
+            std::istringstream(value) >> header.m_dataRate;
+        }
+    }
+    file.close();
+
+    CsvReader csv(path);
+    std::vector<uint64_t> sizes;
+    std::vector<uint64_t> periods;
+    std::vector<uint8_t> importances;
+    uint64_t maxSize = 0;
+    uint64_t maxPeriod = 0;
+    uint64_t burstSize;
+    Time period;
+    uint8_t importance;
+    while (csv.FetchNextRow())
+    {
+        // Ignore blank lines
+        if (csv.IsBlankRow())
+        {
+            continue;
+        }
+
+        ParseCsvRow(csv, path, burstSize, period, importance);
+        sizes.push_back(burstSize);
+        periods.push_back(period.GetNanoSeconds());
+        importances.push_back(importance);
+        header.m_duration += periods.back();
+        maxSize = std::max(maxSize, burstSize);
+        maxPeriod = std::max(maxPeriod, periods.back());
+        if (importance > 0)
+        {
+            header.m_flags |= BurstTraceFileHeader::HAS_IMPORTANCE;
+        }
+    } // while FetchNextRow
+
+    // arrays are packed on 4 bytes per element, unless some element does not fit
+    uint64_t nBursts = sizes.size();
+    uint64_t maxPacked = std::numeric_limits<uint32_t>::max();
+    header.m_nBursts = nBursts;
+    header.m_sizeWidth = maxSize > maxPacked ? 8 : 4;
+    header.m_periodWidth = maxPeriod > maxPacked ? 8 : 4;
+
+    uint64_t sizesOffset = header.GetSizesOffset();
+    uint64_t periodsOffset = header.GetPeriodsOffset();
+    uint64_t importanceOffset = header.GetImportanceOffset();
+    bool hasImportance = header.m_flags & BurstTraceFileHeader::HAS_IMPORTANCE;
+
+    Ptr<BurstTrace> trace = Ptr<BurstTrace>(new BurstTrace(path), false);
+    std::vector<uint8_t>& image = trace->m_image;
+    image.assign(header.GetFileSize(), 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    for (uint64_t index = 0; index < nBursts; index++)
+    {
+        WritePacked(image.data() + sizesOffset, header.m_sizeWidth, index, sizes[index]);
+        WritePacked(image.data() + periodsOffset, header.m_periodWidth, index, periods[index]);
+        if (hasImportance)
+        {
+            image[importanceOffset + index] = importances[index];
+        }
+    }
+    trace->Attach(image.data(), image.size());
+
+    NS_LOG_INFO("Parsed " << trace->GetNBursts() << " bursts from file " << path);
+    return trace;
+}
+
+} // namespace ns3
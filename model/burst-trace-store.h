@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef BURST_TRACE_STORE_H
+#define BURST_TRACE_STORE_H
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class CsvReader;
+
+/**
+ * @ingroup applications
+ *
+ * @brief Fixed header of a binary burst trace file
+ *
+ * A binary trace file starts with this header, followed by the packed array
+ * of the burst sizes [B] and the packed array of the periods to the next
+ * burst [ns], each padded to a multiple of 8 bytes, and, if the
+ * HAS_IMPORTANCE flag is set, by the importance classes, one byte per burst.
+ * Sizes and periods take 4 bytes each, or 8 bytes if some of them does not
+ * fit, so that any burst can be accessed in place.
+ * All fields are in the byte order of the host writing the file.
+ */
+struct BurstTraceFileHeader
+{
+    /// The version of the format
+    static const uint32_t VERSION = 1;
+    /// Flag of the traces carrying importance classes
+    static const uint32_t HAS_IMPORTANCE = 0x1;
+
+    /**
+     * @brief Reset the header to the one of an empty trace of the current version
+     */
+    void Reset(void);
+
+    /**
+     * @brief Check whether the header starts with the magic string of binary traces
+     * @return true if the magic string is found
+     */
+    bool HasMagic(void) const;
+
+    /**
+     * @brief Check whether the header can be read by this version of the format
+     * @return true if the magic string, the version, the byte order and the widths are valid
+     */
+    bool IsValid(void) const;
+
+    /**
+     * @brief Get the offset of the burst sizes from the start of the file
+     * @return the offset [B]
+     */
+    uint64_t GetSizesOffset(void) const;
+
+    /**
+     * @brief Get the offset of the periods from the start of the file
+     * @return the offset [B]
+     */
+    uint64_t GetPeriodsOffset(void) const;
+
+    /**
+     * @brief Get the offset of the importance classes from the start of the file
+     * @return the offset [B]
+     */
+    uint64_t GetImportanceOffset(void) const;
+
+    /**
+     * @brief Get the size of the file
+     * @return the size of the header and of the arrays [B]
+     */
+    uint64_t GetFileSize(void) const;
+
+    char m_magic[8];        //!< "BURSTTRC", telling binary traces from CSV ones
+    uint32_t m_version;     //!< The version of the format, also telling the byte order
+    uint32_t m_flags;       //!< The flags of the trace
+    uint64_t m_nBursts;     //!< The number of bursts
+    uint32_t m_sizeWidth;   //!< The bytes per burst size, either 4 or 8
+    uint32_t m_periodWidth; //!< The bytes per period, either 4 or 8
+    double m_frameRate;     //!< The frame rate of the traced application [FPS], 0 if unknown
+    double m_dataRate;      //!< The data rate of the traced application [Mbps], 0 if unknown
+    uint64_t m_duration;    //!< The duration of the trace, i.e., the sum of the periods [ns]
+    char m_appName[64];     //!< The name of the traced application, null-terminated
+};
+
+/**
+ * @ingroup applications
+ *
+ * @brief Immutable burst trace, shared by the generators reading the same file
+ *
+ * Each burst of the trace is described by its size, the period to the next
+ * burst and its importance class, stored in packed arrays indexed by the
+ * position of the burst in the trace.
+ * A prefix sum of the periods indexes the bursts by their start time, so
+ * that a generator can start from any time of the trace with a binary
+ * search.
+ * The trace is held in the binary format described by BurstTraceFileHeader:
+ * binary trace files are memory-mapped, while CSV trace files are converted
+ * once in memory.
+ * Traces are only built by the BurstTraceStore, and never modified
+ * afterwards: generators read them through a cursor of their own.
+ */
+class BurstTrace : public SimpleRefCount<BurstTrace>
+{
+  public:
+    ~BurstTrace();
+
+    /**
+     * @brief Get the path of the file the trace was read from
+     * @return the path of the trace file
+     */
+    const std::string& GetPath(void) const;
+
+    /**
+     * @brief Get the name of the traced application
+     * @return the name of the application, empty if unknown
+     */
+    std::string GetAppName(void) const;
+
+    /**
+     * @brief Get the frame rate of the traced application
+     * @return the frame rate [FPS], 0 if unknown
+     */
+    double GetFrameRate(void) const;
+
+    /**
+     * @brief Get the data rate of the traced application
+     * @return the data rate [Mbps], 0 if unknown
+     */
+    double GetDataRate(void) const;
+
+    /**
+     * @brief Get the duration of the whole trace
+     * @return the sum of the periods of all bursts
+     */
+    Time GetDuration(void) const;
+
+    /**
+     * @brief Get the number of bursts in the trace
+     * @return the number of bursts
+     */
+    uint64_t GetNBursts(void) const;
+
+    /**
+     * @brief Get the size of a burst
+     * @param index the position of the burst in the trace
+     * @return the size of the burst [B]
+     */
+    uint64_t GetBurstSize(uint64_t index) const;
+
+    /**
+     * @brief Get the period from a burst to the next one
+     * @param index the position of the burst in the trace
+     * @return the period to the next burst
+     */
+    Time GetPeriod(uint64_t index) const;
+
+    /**
+     * @brief Get the time of a burst since the start of the trace
+     * @param index the position of the burst in the trace, up to the number of bursts
+     * @return the sum of the periods of the previous bursts
+     */
+    Time GetBurstStart(uint64_t index) const;
+
+    /**
+     * @brief Find the first burst starting at or after a time, with a binary search
+     * @param time the time since the start of the trace
+     * @return the position of the burst, or the number of bursts if none
+     */
+    uint64_t FindBurst(Time time) const;
+
+    /**
+     * @brief Get the importance class of a burst
+     * @param index the position of the burst in the trace
+     * @return the importance class of the burst, 0 if the trace has none
+     */
+    uint8_t GetImportance(uint64_t index) const;
+
+    /**
+     * @brief Get the heap memory held by the trace
+     * @return the size of the trace [B], excluding memory-mapped files
+     */
+    uint64_t GetMemoryUsage(void) const;
+
+    /**
+     * @brief Check whether the trace is memory-mapped from a binary file
+     * @return true if the trace is memory-mapped
+     */
+    bool IsMapped(void) const;
+
+    /**
+     * @brief Write the trace to a binary trace file
+     * @param path the path of the binary trace file
+     */
+    void Save(const std::string& path) const;
+
+    /**
+     * @brief Read an integer of a packed array
+     * @param array the packed array
+     * @param width the size of each element, either 4 or 8 bytes
+     * @param index the position of the element
+     * @return the element
+     */
+    static uint64_t ReadPacked(const uint8_t* array, uint32_t width, uint64_t index);
+
+  private:
+    friend class BurstTraceStore;
+
+    /**
+     * @brief constructor
+     * @param path the path of the trace file
+     */
+    BurstTrace(const std::string& path);
+
+    /**
+     * @brief Validate the binary image of the trace and locate its arrays
+     * @param data the binary image of the trace
+     * @param length the size of the binary image [B]
+     */
+    void Attach(const uint8_t* data, uint64_t length);
+
+    std::string m_path;                //!< The path of the trace file
+    std::vector<uint8_t> m_image;      //!< The binary image of the trace, unless memory-mapped
+    void* m_mapping{nullptr};          //!< The memory-mapped trace file, if any
+    const uint8_t* m_data{nullptr};    //!< The binary image of the trace
+    uint64_t m_length{0};              //!< The size of the binary image [B]
+    BurstTraceFileHeader m_header;     //!< The header of the binary image
+    const uint8_t* m_sizes{nullptr};   //!< The packed burst sizes [B]
+    const uint8_t* m_periods{nullptr}; //!< The packed periods to the next burst [ns]
+    std::vector<uint64_t> m_starts;    //!< The start time of each burst, then the duration [ns]
+
+    /// The importance classes, null if all 0
+    const uint8_t* m_importance{nullptr};
+};
+
+/**
+ * @ingroup applications
+ *
+ * @brief Process-wide cache of the burst traces, keyed by the path of their file
+ *
+ * A trace file is read only the first time it is requested, and the
+ * same BurstTrace is then shared by all the generators reading it, so that
+ * the startup time and the memory do not grow with the number of users of
+ * the same trace. Traces are reference counted, and released once no
+ * generator uses them.
+ * Files are told apart by their path as given, without resolving it.
+ *
+ * Both CSV and binary trace files are accepted, the latter being recognized
+ * by the magic string at the start of their BurstTraceFileHeader. The
+ * comment lines of CSV trace files can carry the name, frame rate and data
+ * rate of the traced application, as "# Application: ...",
+ * "# Frame rate: ... FPS" and "# Data rate: ... Mbps".
+ */
+class BurstTraceStore
+{
+  public:
+    /**
+     * @brief Get a trace, reading its file if not already cached
+     * @param path the path of the trace file, either CSV or binary
+     * @return the trace
+     */
+    static Ptr<const BurstTrace> Get(const std::string& path);
+
+    /**
+     * @brief Release the cached traces no longer used by any generator
+     */
+    static void Purge(void);
+
+    /**
+     * @brief Get the number of cached traces
+     * @return the number of cached traces
+     */
+    static uint32_t GetNTraces(void);
+
+    /**
+     * @brief Parse a row of a CSV trace file, aborting if malformed
+     * @param csv the CSV reader, at a non-blank row
+     * @param path the path of the trace file
+     * @param size the size of the burst [B]
+     * @param period the period to the next burst
+     * @param importance the importance class of the burst, 0 if missing
+     */
+    static void ParseCsvRow(const CsvReader& csv,
+                            const std::string& path,
+                            uint64_t& size,
+                            Time& period,
+                            uint8_t& importance);
+
+  private:
+    /**
+     * @brief Get the cached traces
+     * @return the cached traces, by path
+     */
+    static std::map<std::string, Ptr<BurstTrace>>& GetTraces(void);
+
+    /**
+     * @brief Memory-map a binary trace file
+     * @param path the path of the trace file
+     * @return the trace
+     */
+    static Ptr<BurstTrace> MapBinary(const std::string& path);
+
+    /**
+     * @brief Parse a CSV trace file into a binary image
+     * @param path the path of the trace file
+     * @return the trace
+     */
+    static Ptr<BurstTrace> ImportCsv(const std::string& path);
+};
+
+} // namespace ns3
+
+#endif /* BURST_TRACE_STORE_H */
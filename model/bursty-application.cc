@@ -10,26 +10,46 @@
 #include "bursty-application.h"
 
 #include "burst-generator.h"
+#include "burst-stream-deframer.h"
+#include "compact-frag-header.h"
 
 #include "ns3/address.h"
 #include "ns3/boolean.h"
+#include "ns3/channel.h"
 #include "ns3/data-rate.h"
+#include "ns3/enum.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-routing-protocol.h"
+#include "ns3/ipv6.h"
 #include "ns3/log.h"
+#include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/nstime.h"
 #include "ns3/packet-socket-address.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-disc.h"
+#include "ns3/queue.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
 #include "ns3/socket.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/traffic-control-layer.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 namespace ns3
 {
 
@@ -37,6 +57,32 @@ NS_LOG_COMPONENT_DEFINE("BurstyApplication");
 
 NS_OBJECT_ENSURE_REGISTERED(BurstyApplication);
 
+/**
+ * @brief Format an address for logging
+ * @param address the address
+ * @return the IP address and port, if any
+ */
+static std::string
+AddressToString(const Address& address)
+{
+    std::stringstream addressStr;
+    if (InetSocketAddress::IsMatchingType(address))
+    {
+        addressStr << InetSocketAddress::ConvertFrom(address).GetIpv4() << " port "
+                   << InetSocketAddress::ConvertFrom(address).GetPort();
+    }
+    else if (Inet6SocketAddress::IsMatchingType(address))
+    {
+        addressStr << Inet6SocketAddress::ConvertFrom(address).GetIpv6() << " port "
+                   << Inet6SocketAddress::ConvertFrom(address).GetPort();
+    }
+    else
+    {
+        addressStr << "UNKNOWN ADDRESS TYPE";
+    }
+    return addressStr.str();
+}
+
 TypeId
 BurstyApplication::GetTypeId(void)
 {
@@ -46,7 +92,7 @@ BurstyApplication::GetTypeId(void)
             .SetGroupName("Applications")
             .AddConstructor<BurstyApplication>()
             .AddAttribute("FragmentSize",
-                          "The size of packets sent in a burst including SeqTsSizeFragHeader",
+                          "The size of packets sent in a burst including their header",
                           UintegerValue(1200),
                           MakeUintegerAccessor(&BurstyApplication::m_fragSize),
                           MakeUintegerChecker<uint32_t>(1))
@@ -57,7 +103,8 @@ BurstyApplication::GetTypeId(void)
                           MakeAddressChecker())
             .AddAttribute("Local",
                           "The Address on which to bind the socket. If not set, it is generated "
-                          "automatically.",
+                          "automatically. The sockets of further remotes bind to the same IP "
+                          "address, on an ephemeral port.",
                           AddressValue(),
                           MakeAddressAccessor(&BurstyApplication::m_local),
                           MakeAddressChecker())
@@ -72,6 +119,86 @@ BurstyApplication::GetTypeId(void)
                           TypeIdValue(UdpSocketFactory::GetTypeId()),
                           MakeTypeIdAccessor(&BurstyApplication::m_socketTid),
                           MakeTypeIdChecker())
+            .AddAttribute("PacingWindow",
+                          "If strictly positive, the fragments of each burst are spread evenly "
+                          "over this time window. Takes precedence over PacingRate.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&BurstyApplication::m_pacingWindow),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("PacingRate",
+                          "If strictly positive and PacingWindow is zero, the fragments of each "
+                          "burst are paced at this data rate. Zero disables pacing.",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&BurstyApplication::m_pacingRate),
+                          MakeDataRateChecker())
+            .AddAttribute("FecScheme",
+                          "The forward error correction scheme used to compute the parity "
+                          "fragments of each burst.",
+                          EnumValue(BurstFecCodec::None),
+                          MakeEnumAccessor<BurstFecCodec::Scheme>(&BurstyApplication::m_fecScheme),
+                          MakeEnumChecker(BurstFecCodec::None,
+                                          "None",
+                                          BurstFecCodec::Xor,
+                                          "Xor",
+                                          BurstFecCodec::ReedSolomon,
+                                          "ReedSolomon"))
+            .AddAttribute("FecParityFragments",
+                          "The number of parity fragments sent after the data fragments of each "
+                          "burst, if FecScheme is not None. The XOR scheme uses at most as many "
+                          "parity fragments as data fragments.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&BurstyApplication::m_fecParity),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("RetransmissionBuffer",
+                          "The number of most recent bursts whose fragments are kept to be "
+                          "retransmitted upon NACKs from the BurstSink. Zero disables "
+                          "retransmissions.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&BurstyApplication::m_retxBufferSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("RetransmissionDeadline",
+                          "If strictly positive, fragments of bursts created longer than this "
+                          "time ago are not retransmitted.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&BurstyApplication::m_retxDeadline),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("RateController",
+                          "If set, the BurstRateController retuning the TargetDataRate attribute "
+                          "of the BurstGenerator upon the reception reports of the BurstSink.",
+                          PointerValue(0),
+                          MakePointerAccessor(&BurstyApplication::m_rateController),
+                          MakePointerChecker<BurstRateController>())
+            .AddAttribute("HeaderFormat",
+                          "The serialization format of the fragment headers, either the "
+                          "fixed-size SeqTsSizeFragHeader or the variable-length "
+                          "CompactFragHeader. Must match the one of the BurstSink.",
+                          EnumValue(SeqTsSizeFragHeader::Full),
+                          MakeEnumAccessor<SeqTsSizeFragHeader::Format>(
+                              &BurstyApplication::m_headerFormat),
+                          MakeEnumChecker(SeqTsSizeFragHeader::Full,
+                                          "Full",
+                                          SeqTsSizeFragHeader::Compact,
+                                          "Compact"))
+            .AddAttribute("DeadlinePolicy",
+                          "The policy for the bursts which cannot be sent within their deadline, "
+                          "given the pacing backlog, the occupancy of the TX buffer of stream "
+                          "sockets and the time to drain the queue disc and the device queues "
+                          "towards the peer at their measured dequeue rate or at the link rate.",
+                          EnumValue(BurstyApplication::NoDeadline),
+                          MakeEnumAccessor<BurstyApplication::DeadlinePolicy>(
+                              &BurstyApplication::m_deadlinePolicy),
+                          MakeEnumChecker(BurstyApplication::NoDeadline,
+                                          "None",
+                                          BurstyApplication::DropBurst,
+                                          "Drop",
+                                          BurstyApplication::TruncateBurst,
+                                          "Truncate"))
+            .AddAttribute("BurstDeadline",
+                          "The deadline of each burst since its creation, if DeadlinePolicy is "
+                          "not None. If zero, the period to the next burst is used.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&BurstyApplication::m_burstDeadline),
+                          MakeTimeChecker(Seconds(0)))
             .AddTraceSource("FragmentTx",
                             "A fragment of the burst is sent",
                             MakeTraceSourceAccessor(&BurstyApplication::m_txFragmentTrace),
@@ -79,16 +206,27 @@ BurstyApplication::GetTypeId(void)
             .AddTraceSource("BurstTx",
                             "A burst of packet is created and sent",
                             MakeTraceSourceAccessor(&BurstyApplication::m_txBurstTrace),
-                            "ns3::BurstSink::SeqTsSizeFragCallback");
+                            "ns3::BurstSink::SeqTsSizeFragCallback")
+            .AddTraceSource("FragmentRetx",
+                            "A fragment of the burst is retransmitted upon a NACK",
+                            MakeTraceSourceAccessor(&BurstyApplication::m_retxFragmentTrace),
+                            "ns3::BurstSink::SeqTsSizeFragCallback")
+            .AddTraceSource("BurstDropped",
+                            "A burst, or its last fragments, is dropped as it cannot make its "
+                            "deadline",
+                            MakeTraceSourceAccessor(&BurstyApplication::m_droppedBurstTrace),
+                            "ns3::BurstyApplication::DroppedBurstCallback");
     return tid;
 }
 
 BurstyApplication::BurstyApplication()
-    : m_socket(0),
-      m_connected(false),
+    : m_connected(false),
+      m_streamFraming(false),
       m_totTxBursts(0),
       m_totTxFragments(0),
-      m_totTxBytes(0)
+      m_totTxBytes(0),
+      m_totRetxFragments(0),
+      m_totDroppedBursts(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -102,7 +240,36 @@ Ptr<Socket>
 BurstyApplication::GetSocket(void) const
 {
     NS_LOG_FUNCTION(this);
-    return m_socket;
+    return m_receivers.empty() ? 0 : m_receivers.front().m_socket;
+}
+
+void
+BurstyApplication::AddRemote(const Address& remote)
+{
+    NS_LOG_FUNCTION(this << remote);
+    NS_ABORT_MSG_IF(!m_receivers.empty(), "Remotes must be added before the application starts");
+    m_extraRemotes.push_back(remote);
+}
+
+void
+BurstyApplication::SetImportancePriority(uint8_t importance, uint8_t priority)
+{
+    NS_LOG_FUNCTION(this << +importance << +priority);
+    ImportanceTags& tags = m_importanceTags[importance];
+    tags.m_hasPriority = true;
+    tags.m_priority = priority;
+    tags.m_hasTos = false;
+}
+
+void
+BurstyApplication::SetImportanceTos(uint8_t importance, uint8_t tos)
+{
+    NS_LOG_FUNCTION(this << +importance << +tos);
+    ImportanceTags& tags = m_importanceTags[importance];
+    tags.m_hasPriority = true;
+    tags.m_priority = Socket::IpTos2Priority(tos);
+    tags.m_hasTos = true;
+    tags.m_tos = tos;
 }
 
 Ptr<BurstGenerator>
@@ -117,8 +284,16 @@ BurstyApplication::DoDispose(void)
     NS_LOG_FUNCTION(this);
 
     CancelEvents();
-    m_socket = 0;
+    m_pendingFragments.clear();
+    m_txBatch.clear();
+    m_fecDataBuffer.clear();
+    m_fecParityBuffer.clear();
+    m_retxBuffer.clear();
+    m_importanceTags.clear();
+    m_receivers.clear();
+    m_extraRemotes.clear();
     m_burstGenerator = 0;
+    m_rateController = 0;
 
     // chain up
     Application::DoDispose();
@@ -129,45 +304,25 @@ BurstyApplication::StartApplication()
 {
     NS_LOG_FUNCTION(this);
 
-    // Create the socket if not already
-    if (!m_socket)
+    // Create the sockets if not already, Remote first
+    if (m_receivers.empty())
     {
-        m_socket = Socket::CreateSocket(GetNode(), m_socketTid);
-        int ret = -1;
-
-        if (!m_local.IsInvalid())
+        m_receivers.push_back({m_peer});
+        for (const auto& remote : m_extraRemotes)
         {
-            NS_ABORT_MSG_IF((Inet6SocketAddress::IsMatchingType(m_peer) &&
-                             InetSocketAddress::IsMatchingType(m_local)) ||
-                                (InetSocketAddress::IsMatchingType(m_peer) &&
-                                 Inet6SocketAddress::IsMatchingType(m_local)),
-                            "Incompatible peer and local address IP version");
-            ret = m_socket->Bind(m_local);
+            m_receivers.push_back({remote});
         }
-        else
+        for (auto& receiver : m_receivers)
         {
-            if (Inet6SocketAddress::IsMatchingType(m_peer))
-            {
-                ret = m_socket->Bind6();
-            }
-            else if (InetSocketAddress::IsMatchingType(m_peer) ||
-                     PacketSocketAddress::IsMatchingType(m_peer))
-            {
-                ret = m_socket->Bind();
-            }
+            CreateSocket(receiver);
+            NS_ABORT_MSG_IF(m_deadlinePolicy != NoDeadline && !IsPacingEnabled() &&
+                                !m_streamFraming && !receiver.m_queueDisc &&
+                                receiver.m_deviceQueues.empty(),
+                            "DeadlinePolicy needs pacing, a stream socket or the queues of "
+                            "the device towards "
+                                << AddressToString(receiver.m_peer)
+                                << " to estimate the backlog of the bursts");
         }
-
-        if (ret == -1)
-        {
-            NS_FATAL_ERROR("Failed to bind socket");
-        }
-
-        m_socket->Connect(m_peer);
-        m_socket->SetAllowBroadcast(true);
-        m_socket->ShutdownRecv();
-
-        m_socket->SetConnectCallback(MakeCallback(&BurstyApplication::ConnectionSucceeded, this),
-                                     MakeCallback(&BurstyApplication::ConnectionFailed, this));
     }
 
     // Ensure no pending event
@@ -181,14 +336,241 @@ BurstyApplication::StopApplication()
     NS_LOG_FUNCTION(this);
 
     CancelEvents();
-    if (m_socket)
+    if (!m_pendingFragments.empty())
     {
-        m_socket->Close();
+        NS_LOG_LOGIC("Discarding " << m_pendingFragments.size() << " paced fragments");
+        m_pendingFragments.clear();
     }
-    else
+    m_retxBuffer.clear();
+    if (m_receivers.empty())
     {
         NS_LOG_WARN("BurstyApplication found null socket to close in StopApplication");
     }
+    for (auto& receiver : m_receivers)
+    {
+        receiver.m_socket->Close();
+        receiver.m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+}
+
+void
+BurstyApplication::CreateSocket(Receiver& receiver)
+{
+    NS_LOG_FUNCTION(this << receiver.m_peer);
+
+    receiver.m_socket = Socket::CreateSocket(GetNode(), m_socketTid);
+    int ret = -1;
+
+    if (!m_local.IsInvalid())
+    {
+        NS_ABORT_MSG_IF((Inet6SocketAddress::IsMatchingType(receiver.m_peer) &&
+                         InetSocketAddress::IsMatchingType(m_local)) ||
+                            (InetSocketAddress::IsMatchingType(receiver.m_peer) &&
+                             Inet6SocketAddress::IsMatchingType(m_local)),
+                        "Incompatible peer and local address IP version");
+        // only the socket of Remote takes the port of Local, the others bind to an ephemeral one
+        Address local = m_local;
+        if (&receiver != &m_receivers.front() && InetSocketAddress::IsMatchingType(m_local))
+        {
+            local = InetSocketAddress(InetSocketAddress::ConvertFrom(m_local).GetIpv4(), 0);
+        }
+        else if (&receiver != &m_receivers.front() && Inet6SocketAddress::IsMatchingType(m_local))
+        {
+            local = Inet6SocketAddress(Inet6SocketAddress::ConvertFrom(m_local).GetIpv6(), 0);
+        }
+        ret = receiver.m_socket->Bind(local);
+    }
+    else
+    {
+        if (Inet6SocketAddress::IsMatchingType(receiver.m_peer))
+        {
+            ret = receiver.m_socket->Bind6();
+        }
+        else if (InetSocketAddress::IsMatchingType(receiver.m_peer) ||
+                 PacketSocketAddress::IsMatchingType(receiver.m_peer))
+        {
+            ret = receiver.m_socket->Bind();
+        }
+    }
+
+    if (ret == -1)
+    {
+        NS_FATAL_ERROR("Failed to bind socket");
+    }
+
+    // byte streams do not preserve the boundaries of the fragments
+    m_streamFraming = receiver.m_socket->GetSocketType() == Socket::NS3_SOCK_STREAM;
+    receiver.m_socket->Connect(receiver.m_peer);
+    receiver.m_socket->SetAllowBroadcast(true);
+    // datagram sockets never report any TX buffer occupancy, only the queues towards the
+    // peer do: the route is looked up once, when the application starts
+    receiver.m_txIdle = receiver.m_socket->GetTxAvailable();
+    FindQueues(receiver);
+    if (m_retxBufferSize > 0 || m_rateController)
+    {
+        // NACKs and reception reports are received on the same socket
+        receiver.m_socket->SetRecvCallback(MakeCallback(&BurstyApplication::HandleRead, this));
+    }
+    else
+    {
+        receiver.m_socket->ShutdownRecv();
+    }
+
+    receiver.m_socket->SetConnectCallback(
+        MakeCallback(&BurstyApplication::ConnectionSucceeded, this),
+        MakeCallback(&BurstyApplication::ConnectionFailed, this));
+    CacheSocketAddresses(receiver);
+}
+
+Ptr<NetDevice>
+BurstyApplication::FindDevice(const Address& peer) const
+{
+    Ptr<NetDevice> device;
+    Socket::SocketErrno sockErrno;
+    if (InetSocketAddress::IsMatchingType(peer))
+    {
+        Ptr<Ipv4> ipv4 = GetNode()->GetObject<Ipv4>();
+        Ipv4Header header;
+        header.SetDestination(InetSocketAddress::ConvertFrom(peer).GetIpv4());
+        Ptr<Ipv4Route> route =
+            ipv4 && ipv4->GetRoutingProtocol()
+                ? ipv4->GetRoutingProtocol()->RouteOutput(nullptr, header, nullptr, sockErrno)
+                : nullptr;
+        device = route ? route->GetOutputDevice() : nullptr;
+    }
+    else if (Inet6SocketAddress::IsMatchingType(peer))
+    {
+        Ptr<Ipv6> ipv6 = GetNode()->GetObject<Ipv6>();
+        Ipv6Header header;
+        header.SetDestination(Inet6SocketAddress::ConvertFrom(peer).GetIpv6());
+        Ptr<Ipv6Route> route =
+            ipv6 && ipv6->GetRoutingProtocol()
+                ? ipv6->GetRoutingProtocol()->RouteOutput(nullptr, header, nullptr, sockErrno)
+                : nullptr;
+        device = route ? route->GetOutputDevice() : nullptr;
+    }
+    else if (PacketSocketAddress::IsMatchingType(peer))
+    {
+        PacketSocketAddress address = PacketSocketAddress::ConvertFrom(peer);
+        device = address.IsSingleDevice() ? GetNode()->GetDevice(address.GetSingleDevice())
+                                          : nullptr;
+    }
+    return device;
+}
+
+void
+BurstyApplication::FindQueues(Receiver& receiver) const
+{
+    Ptr<NetDevice> device = FindDevice(receiver.m_peer);
+    if (!device)
+    {
+        return;
+    }
+
+    Ptr<TrafficControlLayer> tc = GetNode()->GetObject<TrafficControlLayer>();
+    if (tc)
+    {
+        receiver.m_queueDisc = tc->GetRootQueueDiscOnDevice(device);
+    }
+
+    // the queues of the device are found through its attributes, whatever its type
+    PointerValue queue;
+    PointerValue mac;
+    if (device->GetAttributeFailSafe("TxQueue", queue) && queue.Get<QueueBase>())
+    {
+        receiver.m_deviceQueues.push_back(queue.Get<QueueBase>());
+    }
+    else if (device->GetAttributeFailSafe("Mac", mac) && mac.Get<Object>())
+    {
+        // Wi-Fi devices queue the frames in their MAC, either in a single queue or in one
+        // queue per access category, whose priorities are neglected
+        for (const char* txopName : {"Txop", "VO_Txop", "VI_Txop", "BE_Txop", "BK_Txop"})
+        {
+            PointerValue txop;
+            if (mac.Get<Object>()->GetAttributeFailSafe(txopName, txop) && txop.Get<Object>() &&
+                txop.Get<Object>()->GetAttributeFailSafe("Queue", queue) &&
+                queue.Get<QueueBase>() &&
+                std::find(receiver.m_deviceQueues.begin(),
+                          receiver.m_deviceQueues.end(),
+                          queue.Get<QueueBase>()) == receiver.m_deviceQueues.end())
+            {
+                receiver.m_deviceQueues.push_back(queue.Get<QueueBase>());
+            }
+        }
+    }
+
+    // the data rate is an attribute of either the device or its channel, if known
+    DataRateValue linkRate;
+    if (device->GetAttributeFailSafe("DataRate", linkRate) ||
+        (device->GetChannel() && device->GetChannel()->GetAttributeFailSafe("DataRate", linkRate)))
+    {
+        receiver.m_linkRate = linkRate.Get();
+    }
+}
+
+uint64_t
+BurstyApplication::GetBacklogBytes(const Receiver& receiver) const
+{
+    uint64_t backlog = receiver.m_queueDisc ? receiver.m_queueDisc->GetNBytes() : 0;
+    for (const auto& queue : receiver.m_deviceQueues)
+    {
+        backlog += queue->GetNBytes();
+    }
+    if (m_streamFraming)
+    {
+        // stream sockets keep the bytes not yet acknowledged in their TX buffer
+        uint32_t txAvailable = receiver.m_socket->GetTxAvailable();
+        backlog += receiver.m_txIdle - std::min(receiver.m_txIdle, txAvailable);
+    }
+    return backlog;
+}
+
+uint32_t
+BurstyApplication::GetDequeuedBytes(const Receiver& receiver) const
+{
+    if (receiver.m_deviceQueues.empty())
+    {
+        return receiver.m_queueDisc ? receiver.m_queueDisc->GetStats().nTotalDequeuedBytes : 0;
+    }
+
+    // the queue disc feeds the device queues, whose dequeues reach the channel
+    uint32_t dequeued = 0;
+    for (const auto& queue : receiver.m_deviceQueues)
+    {
+        dequeued += queue->GetTotalReceivedBytes() - queue->GetNBytes();
+    }
+    return dequeued;
+}
+
+void
+BurstyApplication::UpdateDrainRate(Receiver& receiver, uint64_t backlog)
+{
+    Time now = Simulator::Now();
+    uint32_t dequeued = GetDequeuedBytes(receiver);
+    if (receiver.m_backlogged && backlog > 0 && now > receiver.m_sampleTime)
+    {
+        // the queues were busy since the last sample: the counters wrap around at 4 GB
+        uint32_t drained = dequeued - receiver.m_dequeuedBytes;
+        double seconds = (now - receiver.m_sampleTime).GetSeconds();
+        receiver.m_drainRate = DataRate(uint64_t(drained * 8.0 / seconds));
+        receiver.m_hasDrainRate = true;
+    }
+    receiver.m_backlogged = backlog > 0;
+    receiver.m_dequeuedBytes = dequeued;
+    receiver.m_sampleTime = now;
+}
+
+BurstyApplication::Receiver*
+BurstyApplication::FindReceiver(Ptr<Socket> socket)
+{
+    for (auto& receiver : m_receivers)
+    {
+        if (receiver.m_socket == socket)
+        {
+            return &receiver;
+        }
+    }
+    return nullptr;
 }
 
 void
@@ -198,6 +580,8 @@ BurstyApplication::CancelEvents()
 
     // Cancel next burst event
     Simulator::Cancel(m_nextBurstEvent);
+    // Cancel next paced fragment event
+    Simulator::Cancel(m_nextFragmentEvent);
 }
 
 void
@@ -207,10 +591,10 @@ BurstyApplication::SendBurst()
     NS_ASSERT(m_nextBurstEvent.IsExpired());
 
     // get burst info
-    uint32_t burstSize = 0;
+    uint64_t burstSize = 0;
     Time period;
     // packets must be at least as big as the header
-    while (burstSize < 24) // TODO: find a way to improve this
+    while (burstSize < GetMaxHeaderSize(burstSize, 1, GetParityFragments(1)))
     {
         if (!m_burstGenerator->HasNextBurst())
         {
@@ -219,15 +603,24 @@ BurstyApplication::SendBurst()
             return;
         }
 
-        std::tie(burstSize, period) = m_burstGenerator->GenerateBurst();
+        std::tie(burstSize, period) = m_burstGenerator->GenerateLargeBurst();
         NS_LOG_DEBUG("Generated burstSize=" << burstSize << ", period=" << period.As(Time::MS));
     }
 
     NS_ASSERT_MSG(period.IsPositive(),
                   "Period must be non-negative, instead found period=" << period.As(Time::S));
 
-    // send packets for current burst
-    SendFragmentedBurst(burstSize);
+    // fragments are tagged upon the importance class of the burst
+    auto itTags = m_importanceTags.find(m_burstGenerator->GetBurstImportance());
+    m_burstTags = itTags != m_importanceTags.end() ? itTags->second : ImportanceTags();
+
+    // send packets for current burst, which should not delay the next one
+    Time deadline;
+    if (m_deadlinePolicy != NoDeadline)
+    {
+        deadline = m_burstDeadline.IsStrictlyPositive() ? m_burstDeadline : period;
+    }
+    SendFragmentedBurst(burstSize, deadline);
 
     // schedule next burst
     NS_LOG_DEBUG("Next burst scheduled in " << period.As(Time::S));
@@ -235,20 +628,25 @@ BurstyApplication::SendBurst()
 }
 
 void
-BurstyApplication::SendFragmentedBurst(uint32_t burstSize)
+BurstyApplication::SendFragmentedBurst(uint64_t burstSize, Time deadline)
 {
-    NS_LOG_FUNCTION(this << burstSize);
+    NS_LOG_FUNCTION(this << burstSize << deadline);
 
-    // prepare header
-    SeqTsSizeFragHeader hdrTmp;
+    // total number of data fragments, not affected by the shrinking of the second-to-last one
+    uint64_t dataFrags = burstSize / m_fragSize + (burstSize % m_fragSize > 0 ? 1 : 0);
+    NS_ABORT_MSG_IF(dataFrags + m_fecParity > std::numeric_limits<uint32_t>::max(),
+                    "Too many fragments: " << dataFrags << " data + " << m_fecParity
+                                           << " parity");
+    uint32_t totFrags = dataFrags;
+    uint32_t parityFrags = GetParityFragments(totFrags);
 
-    NS_ABORT_MSG_IF(burstSize < hdrTmp.GetSerializedSize(),
-                    burstSize << " < " << hdrTmp.GetSerializedSize());
-    NS_ABORT_MSG_IF(m_fragSize < hdrTmp.GetSerializedSize(),
-                    m_fragSize << " < " << hdrTmp.GetSerializedSize());
+    // all fragments are sized upon the largest header of the burst
+    uint32_t headerSize = GetMaxHeaderSize(burstSize, totFrags, parityFrags);
+    NS_ABORT_MSG_IF(burstSize < headerSize, burstSize << " < " << headerSize);
+    NS_ABORT_MSG_IF(m_fragSize < headerSize, m_fragSize << " < " << headerSize);
 
     // compute number of fragments and sizes
-    uint32_t numFullFrags = burstSize / m_fragSize; // integer division
+    uint64_t numFullFrags = burstSize / m_fragSize; // integer division
     uint32_t lastFragSize = burstSize % m_fragSize; // modulo
 
     uint32_t secondToLastFragSize = 0;
@@ -258,131 +656,773 @@ BurstyApplication::SendFragmentedBurst(uint32_t burstSize)
         secondToLastFragSize = m_fragSize;
         numFullFrags--;
     }
-    if (secondToLastFragSize > 0 &&                // there exist a second-to-last fragment
-        lastFragSize > 0 &&                        // last smaller fragment is needed
-        lastFragSize < hdrTmp.GetSerializedSize()) // the last fragment is below the minimum size
+    if (secondToLastFragSize > 0 && // there exist a second-to-last fragment
+        lastFragSize > 0 &&         // last smaller fragment is needed
+        lastFragSize < headerSize)  // the last fragment is below the minimum size
     {
         // reduce second-to-last fragment to make last fragment of minimum size
-        secondToLastFragSize = m_fragSize + lastFragSize - hdrTmp.GetSerializedSize();
-        lastFragSize =
-            hdrTmp.GetSerializedSize(); // TODO packet with no payload: might be a problem
+        secondToLastFragSize = m_fragSize + lastFragSize - headerSize;
+        lastFragSize = headerSize; // TODO packet with no payload: might be a problem
     }
-    NS_ABORT_MSG_IF(0 < secondToLastFragSize && secondToLastFragSize < hdrTmp.GetSerializedSize(),
-                    secondToLastFragSize << " < " << hdrTmp.GetSerializedSize());
-    NS_ABORT_MSG_IF(0 < lastFragSize && lastFragSize < hdrTmp.GetSerializedSize(),
-                    lastFragSize << " < " << hdrTmp.GetSerializedSize());
+    NS_ABORT_MSG_IF(0 < secondToLastFragSize && secondToLastFragSize < headerSize,
+                    secondToLastFragSize << " < " << headerSize);
+    NS_ABORT_MSG_IF(0 < lastFragSize && lastFragSize < headerSize,
+                    lastFragSize << " < " << headerSize);
+
+    uint64_t burstPayload = burstSize - (uint64_t(headerSize) * totFrags);
+    uint64_t fullFragmentPayload = m_fragSize - headerSize;
 
-    // total number of fragments
-    uint32_t totFrags = numFullFrags;
-    if (secondToLastFragSize > 0)
+    // fragments are filled in order, so that data fragment i carries the payload bytes from
+    // i * shardSize: parity shards are as large as the largest data fragment payload
+    uint32_t shardSize = std::min(fullFragmentPayload, burstPayload);
+    if (shardSize == 0)
     {
-        totFrags++;
+        parityFrags = 0;
     }
-    if (lastFragSize > 0)
+
+    // without FEC, compact fragments are sized upon their own header
+    bool compactSizing = m_headerFormat == SeqTsSizeFragHeader::Compact && parityFrags == 0;
+    uint32_t firstHeaderSize = headerSize;
+    if (compactSizing)
     {
-        totFrags++;
+        burstPayload = burstSize - GetCompactHeadersSize(burstSize, totFrags, firstHeaderSize);
     }
-    uint64_t burstPayload = burstSize - (hdrTmp.GetSerializedSize() * totFrags);
-    uint64_t fullFragmentPayload = m_fragSize - hdrTmp.GetSerializedSize();
+    uint32_t txFrags = totFrags + parityFrags;
     NS_LOG_DEBUG("Current burst size: "
                  << burstSize << " B: " << totFrags << " fragments with total payload "
                  << burstPayload << " B. "
                  << "Sending fragments: " << numFullFrags << " x " << m_fragSize << "B, + "
                  << secondToLastFragSize << " B + " << lastFragSize << " B");
 
-    Ptr<Packet> burst = Create<Packet>(burstPayload);
-    // Trace before adding header, for consistency with BurstSink
-    Address from, to;
-    m_socket->GetSockName(from);
-    m_socket->GetPeerName(to);
+    // packets are limited to 4 GB: larger bursts are not materialized, and their fragments are
+    // created one by one
+    bool largeBurst = burstPayload > std::numeric_limits<uint32_t>::max();
+    NS_ABORT_MSG_IF(largeBurst && parityFrags > 0,
+                    "FEC is not supported for bursts larger than 4 GB");
 
-    // TODO improve
+    SeqTsSizeFragHeader hdrTmp;
     hdrTmp.SetSeq(m_totTxBursts);
     hdrTmp.SetSize(burstPayload);
     hdrTmp.SetFrags(totFrags);
     hdrTmp.SetFragSeq(0);
+    hdrTmp.SetParity(parityFrags);
+    hdrTmp.SetFecScheme(parityFrags > 0 ? m_fecScheme : BurstFecCodec::None);
+
+    // only the leading fragments which can make the deadline are sent
+    Time expiry;
+    uint32_t sendFrags = txFrags;
+    if (deadline.IsStrictlyPositive())
+    {
+        expiry = hdrTmp.GetTs() + deadline;
+        sendFrags = GetDeadlineFragments(txFrags, deadline);
+    }
+    if (sendFrags < txFrags && (m_deadlinePolicy == DropBurst || sendFrags == 0))
+    {
+        // the burst is not sent, and does not take a sequence number
+        NS_LOG_LOGIC("Dropping burst of " << txFrags << " fragments: cannot make its deadline in "
+                                          << deadline.As(Time::MS));
+        m_droppedBurstTrace(hdrTmp, txFrags);
+        m_totDroppedBursts++;
+        return;
+    }
+    if (sendFrags < txFrags)
+    {
+        NS_LOG_LOGIC("Truncating burst to " << sendFrags << " out of " << txFrags
+                                            << " fragments to make its deadline");
+        hdrTmp.SetFragSeq(sendFrags);
+        m_droppedBurstTrace(hdrTmp, txFrags - sendFrags);
+        hdrTmp.SetFragSeq(0);
+        m_totDroppedBursts++;
+    }
+    if (sendFrags < totFrags)
+    {
+        // the burst is announced as made of the data fragments actually sent, as the sinks would
+        // otherwise NACK the dropped ones: their wire sizes are unchanged
+        uint64_t sentBytes = std::min<uint64_t>(sendFrags, numFullFrags) * m_fragSize;
+        if (sendFrags > numFullFrags)
+        {
+            sentBytes += secondToLastFragSize;
+        }
+        uint64_t sentHeadersSize = uint64_t(headerSize) * sendFrags;
+        if (compactSizing)
+        {
+            sentHeadersSize = firstHeaderSize + GetCompactTrailingHeadersSize(sendFrags);
+        }
+        burstPayload = sentBytes - sentHeadersSize;
+        totFrags = sendFrags;
+        parityFrags = 0;
+        txFrags = sendFrags;
+        hdrTmp.SetSize(burstPayload);
+        hdrTmp.SetFrags(totFrags);
+        hdrTmp.SetParity(0);
+        hdrTmp.SetFecScheme(BurstFecCodec::None);
+    }
+
+    Ptr<Packet> burst = Create<Packet>(largeBurst ? 0 : burstPayload);
+    // Trace before adding header, for consistency with BurstSink
+    // TODO improve
+
+    for (const auto& receiver : m_receivers)
+    {
+        m_txBurstTrace(burst, receiver.m_sockName, receiver.m_peerName, hdrTmp);
+    }
 
-    m_txBurstTrace(burst, from, to, hdrTmp);
+    if (m_retxBufferSize > 0)
+    {
+        // keep the fragments of the last bursts, dropping the oldest one
+        if (m_retxBuffer.size() == m_retxBufferSize)
+        {
+            m_retxBuffer.pop_front();
+        }
+        m_retxBuffer.push_back({hdrTmp, {}});
+        m_retxBuffer.back().m_fragments.reserve(txFrags);
+    }
 
+    // all fragments share the header fields and time stamp of the burst
     uint64_t fragmentStart = 0;
-    uint16_t fragmentSeq = 0;
-    for (uint32_t i = 0; i < numFullFrags; i++)
+    uint32_t fragmentSeq = 0;
+    for (uint64_t i = 0; i < numFullFrags && fragmentSeq < sendFrags; i++)
     {
-        Ptr<Packet> fragment = burst->CreateFragment(fragmentStart, fullFragmentPayload);
-        fragmentStart += fullFragmentPayload;
-        SendFragment(fragment, burstPayload, totFrags, fragmentSeq++);
+        hdrTmp.SetFragSeq(fragmentSeq++);
+        uint32_t fragHeaderSize =
+            compactSizing ? GetDataHeaderSize(hdrTmp, firstHeaderSize) : headerSize;
+        uint64_t fragPayload = m_fragSize - fragHeaderSize;
+        Ptr<Packet> fragment = CreateFragmentPayload(burst, fragmentStart, fragPayload);
+        fragmentStart += fragPayload;
+        EnqueueFragment(fragment, hdrTmp, GetPacingGap(m_fragSize, txFrags), expiry);
     }
 
-    if (secondToLastFragSize > 0)
+    if (secondToLastFragSize > 0 && fragmentSeq < sendFrags)
     {
-        uint64_t secondToLastFragPayload = secondToLastFragSize - hdrTmp.GetSerializedSize();
-        Ptr<Packet> fragment = burst->CreateFragment(fragmentStart, secondToLastFragPayload);
+        hdrTmp.SetFragSeq(fragmentSeq++);
+        uint32_t fragHeaderSize =
+            compactSizing ? GetDataHeaderSize(hdrTmp, firstHeaderSize) : headerSize;
+        uint64_t secondToLastFragPayload = secondToLastFragSize - fragHeaderSize;
+        Ptr<Packet> fragment =
+            CreateFragmentPayload(burst, fragmentStart, secondToLastFragPayload);
         fragmentStart += secondToLastFragPayload;
-        SendFragment(fragment, burstPayload, totFrags, fragmentSeq++);
+        EnqueueFragment(fragment, hdrTmp, GetPacingGap(secondToLastFragSize, txFrags), expiry);
     }
 
-    if (lastFragSize > 0)
+    if (lastFragSize > 0 && fragmentSeq < sendFrags)
     {
-        uint64_t lastFragPayload = lastFragSize - hdrTmp.GetSerializedSize();
-        Ptr<Packet> fragment = burst->CreateFragment(fragmentStart, lastFragPayload);
+        hdrTmp.SetFragSeq(fragmentSeq++);
+        uint32_t fragHeaderSize =
+            compactSizing ? GetDataHeaderSize(hdrTmp, firstHeaderSize) : headerSize;
+        uint64_t lastFragPayload = lastFragSize - fragHeaderSize;
+        Ptr<Packet> fragment = CreateFragmentPayload(burst, fragmentStart, lastFragPayload);
         fragmentStart += lastFragPayload;
-        SendFragment(fragment, burstPayload, totFrags, fragmentSeq++);
+        EnqueueFragment(fragment, hdrTmp, GetPacingGap(lastFragSize, txFrags), expiry);
     }
 
-    NS_ASSERT(fragmentStart == burst->GetSize());
+    NS_ASSERT(fragmentStart == burstPayload);
+
+    if (parityFrags > 0 && sendFrags > totFrags)
+    {
+        SendParityFragments(burst, hdrTmp, shardSize, sendFrags, expiry);
+    }
+    SendFragmentBatch(false);
 
     m_totTxBursts++;
 }
 
 void
-BurstyApplication::SendFragment(Ptr<Packet> fragment,
-                                uint64_t burstSize,
-                                uint16_t totFrags,
-                                uint16_t fragmentSeq)
+BurstyApplication::SendParityFragments(Ptr<const Packet> burst,
+                                       SeqTsSizeFragHeader header,
+                                       uint32_t shardSize,
+                                       uint32_t txFrags,
+                                       Time expiry)
+{
+    NS_LOG_FUNCTION(this << burst << header << shardSize << txFrags << expiry);
+
+    uint32_t frags = header.GetFrags();
+    uint32_t parityFrags = header.GetParity();
+    m_fecCodec.Configure(BurstFecCodec::Scheme(header.GetFecScheme()), frags, parityFrags);
+
+    // data shards are the burst payload, zero-padded to a multiple of the shard size
+    m_fecDataBuffer.assign(size_t(frags) * shardSize, 0);
+    m_fecParityBuffer.resize(size_t(parityFrags) * shardSize);
+    burst->CopyData(m_fecDataBuffer.data(), burst->GetSize());
+    m_fecCodec.Encode(m_fecDataBuffer.data(), m_fecParityBuffer.data(), shardSize);
+
+    for (uint32_t p = 0; p < parityFrags && frags + p < txFrags; p++)
+    {
+        Ptr<Packet> fragment =
+            Create<Packet>(m_fecParityBuffer.data() + size_t(p) * shardSize, shardSize);
+        header.SetFragSeq(frags + p);
+        uint32_t paritySize = shardSize + GetHeaderSize(header);
+        EnqueueFragment(fragment, header, GetPacingGap(paritySize, frags + parityFrags), expiry);
+    }
+}
+
+Ptr<Packet>
+BurstyApplication::CreateFragmentPayload(Ptr<const Packet> burst,
+                                         uint64_t start,
+                                         uint32_t size) const
 {
-    NS_LOG_FUNCTION(this << fragment << burstSize << totFrags << fragmentSeq);
+    if (start + size > burst->GetSize())
+    {
+        // the burst is not materialized
+        return Create<Packet>(size);
+    }
+    return burst->CreateFragment(start, size);
+}
 
+uint32_t
+BurstyApplication::GetParityFragments(uint32_t totFrags) const
+{
+    if (m_fecScheme == BurstFecCodec::None)
+    {
+        return 0;
+    }
+    if (m_fecScheme == BurstFecCodec::Xor)
+    {
+        return std::min<uint32_t>(m_fecParity, totFrags);
+    }
+    return m_fecParity;
+}
+
+uint32_t
+BurstyApplication::GetHeaderSize(const SeqTsSizeFragHeader& header) const
+{
+    if (m_headerFormat == SeqTsSizeFragHeader::Compact)
+    {
+        return CompactFragHeader(header).GetSerializedSize();
+    }
+    return header.GetSerializedSize();
+}
+
+uint32_t
+BurstyApplication::GetMaxHeaderSize(uint64_t burstSize,
+                                    uint32_t totFrags,
+                                    uint32_t parityFrags) const
+{
+    // the header of fragment 0, or of the last parity fragment, carries the metadata of the burst
+    // with the largest fields: the burst size is an upper bound to the size of its payload
     SeqTsSizeFragHeader header;
     header.SetSeq(m_totTxBursts);
     header.SetSize(burstSize);
     header.SetFrags(totFrags);
-    header.SetFragSeq(fragmentSeq);
-    fragment->AddHeader(header);
+    header.SetFragSeq(parityFrags > 0 ? totFrags + parityFrags - 1 : 0);
+    header.SetParity(parityFrags);
+    header.SetFecScheme(parityFrags > 0 ? m_fecScheme : BurstFecCodec::None);
+    return GetHeaderSize(header);
+}
 
-    uint32_t fragmentSize = fragment->GetSize();
-    int actual = m_socket->Send(fragment);
-    if (uint32_t(actual) == fragmentSize)
+uint64_t
+BurstyApplication::GetCompactHeadersSize(uint64_t burstSize,
+                                         uint32_t totFrags,
+                                         uint32_t& firstHeaderSize) const
+{
+    uint64_t headersSize = GetCompactTrailingHeadersSize(totFrags);
+
+    // fragment 0 carries the burst payload, i.e., the bytes left minus its own header
+    uint64_t firstFragBytes = burstSize - headersSize;
+    SeqTsSizeFragHeader header;
+    header.SetSeq(m_totTxBursts);
+    header.SetSize(firstFragBytes);
+    header.SetFrags(totFrags);
+    header.SetFragSeq(0);
+    firstHeaderSize = GetHeaderSize(header);
+
+    header.SetSize(firstFragBytes - firstHeaderSize);
+    uint32_t smallerHeaderSize = GetHeaderSize(header);
+    header.SetSize(firstFragBytes - smallerHeaderSize);
+    if (GetHeaderSize(header) == smallerHeaderSize)
     {
-        Address from, to;
-        m_socket->GetSockName(from);
-        m_socket->GetPeerName(to);
+        firstHeaderSize = smallerHeaderSize;
+    }
+    return headersSize + firstHeaderSize;
+}
 
-        m_txFragmentTrace(fragment,
-                          from,
-                          to,
-                          header); // TODO should fragment already include header in trace?
-        m_totTxFragments++;
-        m_totTxBytes += fragmentSize;
+uint64_t
+BurstyApplication::GetCompactTrailingHeadersSize(uint32_t frags) const
+{
+    // fragments after the first one carry the flags byte and the sequence numbers: the varint of
+    // the fragment sequence number grows by one byte every 7 bits
+    uint64_t headersSize =
+        uint64_t(frags - 1) * (1 + CompactFragHeader::GetVarintSize(m_totTxBursts));
+    for (uint64_t varintStart = 1; varintStart < frags; varintStart <<= 7)
+    {
+        headersSize += frags - varintStart;
+    }
+    return headersSize;
+}
+
+uint32_t
+BurstyApplication::GetDataHeaderSize(const SeqTsSizeFragHeader& header,
+                                     uint32_t firstHeaderSize) const
+{
+    return header.GetFragSeq() == 0 ? firstHeaderSize : GetHeaderSize(header);
+}
+
+uint32_t
+BurstyApplication::GetDeadlineFragments(uint32_t txFrags, Time deadline)
+{
+    // fragments are queued with their length prefix over stream sockets, while the headers of
+    // the lower layers are neglected
+    uint32_t wireSize = m_fragSize + (m_streamFraming ? BurstStreamHeader::SERIALIZED_SIZE : 0);
+    uint64_t sendFrags = txFrags;
+    for (auto& receiver : m_receivers)
+    {
+        // the queues in front of each receiver can only take the fragments fitting in their
+        // free space
+        if (m_streamFraming)
+        {
+            sendFrags =
+                std::min<uint64_t>(sendFrags, receiver.m_socket->GetTxAvailable() / wireSize);
+        }
+        else if (receiver.m_queueDisc && receiver.m_queueDisc->GetMaxSize().GetValue() > 0)
+        {
+            QueueSize current = receiver.m_queueDisc->GetCurrentSize();
+            QueueSize max = receiver.m_queueDisc->GetMaxSize();
+            uint32_t free =
+                max.GetValue() > current.GetValue() ? max.GetValue() - current.GetValue() : 0;
+            sendFrags = std::min<uint64_t>(
+                sendFrags,
+                max.GetUnit() == QueueSizeUnit::BYTES ? free / wireSize : free);
+        }
+
+        // and only the fragments transmitted within the deadline once the backlog drains
+        uint64_t backlog = GetBacklogBytes(receiver);
+        UpdateDrainRate(receiver, backlog);
+        DataRate rate = receiver.m_hasDrainRate ? receiver.m_drainRate : receiver.m_linkRate;
+        if (rate.GetBitRate() == 0)
+        {
+            if (receiver.m_hasDrainRate && backlog > 0)
+            {
+                NS_LOG_LOGIC("The queues towards " << AddressToString(receiver.m_peer)
+                                                   << " are not draining");
+                sendFrags = 0;
+            }
+            continue;
+        }
+        Time drainTime = Seconds(backlog * 8.0 / rate.GetBitRate());
+        Time fragmentTime = rate.CalculateBytesTxTime(wireSize);
+        if (drainTime >= deadline)
+        {
+            sendFrags = 0;
+        }
+        else if (fragmentTime.IsStrictlyPositive())
+        {
+            int64_t slack = (deadline - drainTime).GetTimeStep();
+            sendFrags = std::min<uint64_t>(sendFrags, slack / fragmentTime.GetTimeStep());
+        }
+        NS_LOG_LOGIC("Backlog of " << backlog << " B towards " << AddressToString(receiver.m_peer)
+                                   << " draining at " << rate << " in " << drainTime.As(Time::MS));
+    }
+
+    if (!IsPacingEnabled())
+    {
+        return sendFrags;
+    }
+
+    // paced fragments are sent after the fragments already queued
+    Time backlog = Simulator::GetDelayLeft(m_nextFragmentEvent);
+    for (const auto& pending : m_pendingFragments)
+    {
+        backlog += pending.m_gap;
+    }
+    if (backlog >= deadline)
+    {
+        return 0;
+    }
+    Time gap = GetPacingGap(m_fragSize, txFrags);
+    if (gap.IsStrictlyPositive())
+    {
+        // the first fragment is sent right after the backlog, the others every gap
+        int64_t pacedFrags = (deadline - backlog).GetTimeStep() / gap.GetTimeStep() + 1;
+        sendFrags = std::min<uint64_t>(sendFrags, pacedFrags);
+    }
+    return sendFrags;
+}
+
+bool
+BurstyApplication::IsPacingEnabled() const
+{
+    return m_pacingWindow.IsStrictlyPositive() || m_pacingRate.GetBitRate() > 0;
+}
+
+Time
+BurstyApplication::GetPacingGap(uint32_t fragmentSize, uint32_t totFrags) const
+{
+    if (m_pacingWindow.IsStrictlyPositive())
+    {
+        // fragments evenly spread over the pacing window
+        return m_pacingWindow / int64_t(totFrags);
+    }
+    if (m_pacingRate.GetBitRate() > 0)
+    {
+        // transmission time of the fragment at the pacing rate
+        return m_pacingRate.CalculateBytesTxTime(fragmentSize);
+    }
+    return Seconds(0);
+}
+
+void
+BurstyApplication::EnqueueFragment(Ptr<Packet> fragment,
+                                   const SeqTsSizeFragHeader& header,
+                                   Time gap,
+                                   Time expiry)
+{
+    NS_LOG_FUNCTION(this << fragment << header << gap << expiry);
+
+    // retransmitted fragments keep the tags of the original ones
+    TagFragment(fragment);
+    StoreForRetransmission(fragment, header);
+
+    if (!IsPacingEnabled())
+    {
+        // sent along with the other fragments of the burst, with the header serialized once
+        AddFragmentHeader(fragment, header);
+        m_txBatch.push_back({fragment, header});
+        return;
+    }
+
+    m_pendingFragments.push_back({fragment, header, gap, expiry});
+    NS_LOG_LOGIC("Queued fragment for pacing, " << m_pendingFragments.size()
+                                                << " fragments pending");
+
+    if (m_nextFragmentEvent.IsExpired())
+    {
+        // the pacing engine is idle: start it right away
+        SendPendingFragment();
+    }
+}
+
+void
+BurstyApplication::StoreForRetransmission(Ptr<const Packet> fragment,
+                                          const SeqTsSizeFragHeader& header)
+{
+    if (m_retxBufferSize == 0)
+    {
+        return;
+    }
+
+    SentBurst& sentBurst = m_retxBuffer.back();
+    NS_ASSERT(sentBurst.m_header.GetSeq() == header.GetSeq());
+    NS_ASSERT(sentBurst.m_fragments.size() == header.GetFragSeq());
+    // the copy shares the payload of the fragment, while the header is added to the original
+    sentBurst.m_fragments.push_back(fragment->Copy());
+}
+
+void
+BurstyApplication::TagFragment(Ptr<Packet> fragment) const
+{
+    if (m_burstTags.m_hasPriority)
+    {
+        SocketPriorityTag priorityTag;
+        priorityTag.SetPriority(m_burstTags.m_priority);
+        fragment->ReplacePacketTag(priorityTag);
+    }
+    if (m_burstTags.m_hasTos)
+    {
+        SocketIpTosTag ipTosTag;
+        ipTosTag.SetTos(m_burstTags.m_tos);
+        fragment->ReplacePacketTag(ipTosTag);
+    }
+}
+
+void
+BurstyApplication::HandleRead(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+
+    Receiver* receiver = FindReceiver(socket);
+    NS_ASSERT(receiver);
+
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        if (packet->GetSize() == 0)
+        { // EOF
+            break;
+        }
+
+        if (!m_streamFraming)
+        {
+            // each datagram is a control packet
+            HandleControl(packet, *receiver);
+            continue;
+        }
+
+        // control packets are length-prefixed over byte streams, as the fragments
+        receiver->m_deframer.Push(packet);
+        Ptr<Packet> control;
+        while ((control = receiver->m_deframer.Pop()))
+        {
+            HandleControl(control, *receiver);
+        }
+    }
+}
+
+void
+BurstyApplication::HandleControl(Ptr<Packet> packet, Receiver& receiver)
+{
+    NS_LOG_FUNCTION(this << packet << receiver.m_peer);
+
+    BurstControlHeader control;
+    packet->RemoveHeader(control);
+    if (control.GetType() == BurstControlHeader::Nack)
+    {
+        BurstNackHeader nack;
+        packet->RemoveHeader(nack);
+        HandleNack(nack, receiver);
+    }
+    else if (control.GetType() == BurstControlHeader::Feedback)
+    {
+        BurstFeedbackHeader feedback;
+        packet->RemoveHeader(feedback);
+        HandleFeedback(feedback);
+    }
+    else
+    {
+        NS_LOG_WARN("Ignoring control packet " << control << " from " << receiver.m_peer);
+    }
+}
+
+void
+BurstyApplication::HandleNack(const BurstNackHeader& nack, Receiver& receiver)
+{
+    NS_LOG_FUNCTION(this << nack << receiver.m_peer);
+
+    // bursts are stored in order of sequence number
+    auto it = m_retxBuffer.rbegin();
+    while (it != m_retxBuffer.rend() && it->m_header.GetSeq() != nack.GetBurstSeq())
+    {
+        it++;
+    }
+    if (it == m_retxBuffer.rend())
+    {
+        NS_LOG_LOGIC("Burst " << nack.GetBurstSeq() << " no longer in the retransmission buffer");
+        return;
+    }
+    if (m_retxDeadline.IsStrictlyPositive() &&
+        Simulator::Now() - it->m_header.GetTs() > m_retxDeadline)
+    {
+        NS_LOG_LOGIC("Burst " << nack.GetBurstSeq() << " past its retransmission deadline");
+        return;
+    }
+
+    SeqTsSizeFragHeader header = it->m_header;
+    for (const auto& range : nack.GetRanges())
+    {
+        for (uint32_t fragSeq = range.first;
+             fragSeq < uint32_t(range.first) + range.second && fragSeq < it->m_fragments.size();
+             fragSeq++)
+        {
+            header.SetFragSeq(fragSeq);
+            Ptr<Packet> fragment = it->m_fragments[fragSeq]->Copy();
+            AddFragmentHeader(fragment, header);
+            m_txBatch.push_back({fragment, header});
+        }
+    }
+    // only the receiver which lost the fragments gets them again
+    SendFragmentBatch(true, &receiver);
+}
+
+void
+BurstyApplication::HandleFeedback(const BurstFeedbackHeader& feedback)
+{
+    NS_LOG_FUNCTION(this << feedback);
+
+    if (!m_rateController)
+    {
+        NS_LOG_LOGIC("No rate controller: ignoring reception report " << feedback);
+        return;
+    }
+
+    DataRateValue targetDataRate;
+    NS_ABORT_MSG_UNLESS(m_burstGenerator->GetAttributeFailSafe("TargetDataRate", targetDataRate),
+                        "The BurstGenerator " << m_burstGenerator->GetInstanceTypeId().GetName()
+                                              << " has no TargetDataRate attribute");
+
+    DataRate newDataRate = m_rateController->Update(feedback, targetDataRate.Get());
+    if (newDataRate != targetDataRate.Get())
+    {
+        NS_LOG_LOGIC("Target data rate updated from " << targetDataRate.Get() << " to "
+                                                      << newDataRate);
+        m_burstGenerator->SetAttribute("TargetDataRate", DataRateValue(newDataRate));
+    }
+}
+
+void
+BurstyApplication::SendPendingFragment()
+{
+    NS_LOG_FUNCTION(this);
+
+    // the fragments of bursts past their deadline are dropped, reporting each burst once
+    auto isExpired = [](const PendingFragment& pending) {
+        return pending.m_expiry.IsStrictlyPositive() && Simulator::Now() > pending.m_expiry;
+    };
+    while (!m_pendingFragments.empty() && isExpired(m_pendingFragments.front()))
+    {
+        SeqTsSizeFragHeader header = m_pendingFragments.front().m_header;
+        uint32_t droppedFrags = 0;
+        while (!m_pendingFragments.empty() &&
+               m_pendingFragments.front().m_header.GetSeq() == header.GetSeq())
+        {
+            m_pendingFragments.pop_front();
+            droppedFrags++;
+        }
+        NS_LOG_LOGIC("Dropping " << droppedFrags << " queued fragments of burst " << header.GetSeq()
+                                 << ": past its deadline");
+        m_droppedBurstTrace(header, droppedFrags);
+        m_totDroppedBursts++;
+    }
+    if (m_pendingFragments.empty())
+    {
+        // the gap of the last fragment sent has elapsed: the pacing engine is idle
+        return;
+    }
+
+    PendingFragment pending = m_pendingFragments.front();
+    m_pendingFragments.pop_front();
+    NS_ASSERT_MSG(Simulator::Now() >= m_nextFragmentTime,
+                  "Paced fragment sent " << (m_nextFragmentTime - Simulator::Now()).As(Time::US)
+                                         << " before the pacing gap elapsed");
+    SendFragment(pending.m_fragment, pending.m_header);
+
+    // the engine stays busy for the gap even if the queue is empty, so that the fragments
+    // queued meanwhile are still paced
+    m_nextFragmentTime = Simulator::Now() + pending.m_gap;
+    m_nextFragmentEvent =
+        Simulator::Schedule(pending.m_gap, &BurstyApplication::SendPendingFragment, this);
+}
+
+void
+BurstyApplication::SendFragmentBatch(bool retransmission, Receiver* receiver)
+{
+    NS_LOG_FUNCTION(this << m_txBatch.size() << retransmission << receiver);
+
+    if (m_txBatch.empty())
+    {
+        return;
+    }
+
+    uint64_t batchBytes = 0;
+    uint32_t maxFragmentSize = 0;
+    for (const auto& batched : m_txBatch)
+    {
+        batchBytes += batched.m_fragment->GetSize();
+        maxFragmentSize = std::max(maxFragmentSize, batched.m_fragment->GetSize());
+    }
+
+    for (std::size_t r = 0; r < m_receivers.size(); r++)
+    {
+        Receiver& target = m_receivers[r];
+        if (receiver && receiver != &target)
+        {
+            continue;
+        }
+
+        // a stream socket buffers the whole batch, and would refuse the fragments beyond its
+        // TX space, while a datagram socket only bounds the size of each fragment
+        std::size_t sendFrags = m_txBatch.size();
+        uint32_t txAvailable = target.m_socket->GetTxAvailable();
+        if (m_streamFraming && batchBytes > txAvailable)
+        {
+            uint64_t fittingBytes = 0;
+            sendFrags = 0;
+            while (sendFrags < m_txBatch.size() &&
+                   fittingBytes + m_txBatch[sendFrags].m_fragment->GetSize() <= txAvailable)
+            {
+                fittingBytes += m_txBatch[sendFrags++].m_fragment->GetSize();
+            }
+            NS_LOG_LOGIC("Batch of " << batchBytes << " B exceeds the TX space of " << txAvailable
+                                     << " B for " << AddressToString(target.m_peer) << ": only "
+                                     << sendFrags << " out of " << m_txBatch.size()
+                                     << " fragments sent");
+        }
+        else if (!m_streamFraming && maxFragmentSize > txAvailable)
+        {
+            NS_LOG_LOGIC("Fragments of up to " << maxFragmentSize << " B exceed the TX space of "
+                                               << txAvailable << " B for "
+                                               << AddressToString(target.m_peer));
+        }
 
-        std::stringstream addressStr;
-        if (InetSocketAddress::IsMatchingType(m_peer))
+        // the last receiver gets the fragments, the others copies sharing their buffers
+        bool lastReceiver = receiver || r + 1 == m_receivers.size();
+        for (std::size_t i = 0; i < sendFrags; i++)
         {
-            addressStr << InetSocketAddress::ConvertFrom(m_peer).GetIpv4() << " port "
-                       << InetSocketAddress::ConvertFrom(m_peer).GetPort();
+            const BatchedFragment& batched = m_txBatch[i];
+            SendFragmentTo(target,
+                           lastReceiver ? batched.m_fragment : batched.m_fragment->Copy(),
+                           batched.m_header,
+                           retransmission);
         }
-        else if (Inet6SocketAddress::IsMatchingType(m_peer))
+    }
+
+    // keep the capacity for the next batch
+    m_txBatch.clear();
+}
+
+void
+BurstyApplication::SendFragment(Ptr<Packet> fragment,
+                                const SeqTsSizeFragHeader& header,
+                                bool retransmission)
+{
+    NS_LOG_FUNCTION(this << fragment << header << retransmission);
+
+    // the header is serialized once: the copies share it with the payload of the fragment
+    AddFragmentHeader(fragment, header);
+    for (std::size_t r = 0; r + 1 < m_receivers.size(); r++)
+    {
+        SendFragmentTo(m_receivers[r], fragment->Copy(), header, retransmission);
+    }
+    SendFragmentTo(m_receivers.back(), fragment, header, retransmission);
+}
+
+void
+BurstyApplication::AddFragmentHeader(Ptr<Packet> fragment, const SeqTsSizeFragHeader& header) const
+{
+    if (m_headerFormat == SeqTsSizeFragHeader::Compact)
+    {
+        fragment->AddHeader(CompactFragHeader(header));
+    }
+    else
+    {
+        fragment->AddHeader(header);
+    }
+    if (m_streamFraming)
+    {
+        fragment->AddHeader(BurstStreamHeader(fragment->GetSize()));
+    }
+}
+
+void
+BurstyApplication::SendFragmentTo(Receiver& receiver,
+                                  Ptr<Packet> fragment,
+                                  const SeqTsSizeFragHeader& header,
+                                  bool retransmission)
+{
+    NS_LOG_FUNCTION(this << receiver.m_peer << fragment << header << retransmission);
+
+    uint32_t fragmentSize = fragment->GetSize();
+    int actual = receiver.m_socket->Send(fragment);
+    if (uint32_t(actual) == fragmentSize)
+    {
+        if (retransmission)
         {
-            addressStr << Inet6SocketAddress::ConvertFrom(m_peer).GetIpv6() << " port "
-                       << Inet6SocketAddress::ConvertFrom(m_peer).GetPort();
+            m_retxFragmentTrace(fragment, receiver.m_sockName, receiver.m_peerName, header);
+            m_totRetxFragments++;
         }
         else
         {
-            addressStr << "UNKNOWN ADDRESS TYPE";
+            m_txFragmentTrace(fragment,
+                              receiver.m_sockName,
+                              receiver.m_peerName,
+                              header); // TODO should fragment already include header in trace?
         }
+        m_totTxFragments++;
+        m_totTxBytes += fragmentSize;
 
+        // the peer address is only formatted if logging is enabled
         NS_LOG_INFO("At time " << Simulator::Now().As(Time::S)
                                << " bursty application sent fragment of " << fragment->GetSize()
-                               << " bytes to " << addressStr.str() << " with header=" << header);
+                               << " bytes to " << AddressToString(receiver.m_peer)
+                               << " with header=" << header);
     }
     else
     {
@@ -397,6 +1437,19 @@ BurstyApplication::ConnectionSucceeded(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
     m_connected = true;
+    Receiver* receiver = FindReceiver(socket);
+    if (receiver)
+    {
+        CacheSocketAddresses(*receiver);
+    }
+}
+
+void
+BurstyApplication::CacheSocketAddresses(Receiver& receiver)
+{
+    NS_LOG_FUNCTION(this << receiver.m_peer);
+    receiver.m_socket->GetSockName(receiver.m_sockName);
+    receiver.m_socket->GetPeerName(receiver.m_peerName);
 }
 
 void
@@ -424,4 +1477,16 @@ BurstyApplication::GetTotalTxBytes(void) const
     return m_totTxBytes;
 }
 
+uint64_t
+BurstyApplication::GetTotalRetxFragments(void) const
+{
+    return m_totRetxFragments;
+}
+
+uint64_t
+BurstyApplication::GetTotalDroppedBursts(void) const
+{
+    return m_totDroppedBursts;
+}
+
 } // Namespace ns3
@@ -10,19 +10,31 @@
 #ifndef BURSTY_APPLICATION_H
 #define BURSTY_APPLICATION_H
 
+#include "burst-control-header.h"
+#include "burst-fec-codec.h"
+#include "burst-rate-controller.h"
+#include "burst-stream-deframer.h"
 #include "seq-ts-size-frag-header.h"
 
 #include "ns3/address.h"
 #include "ns3/application.h"
 #include "ns3/data-rate.h"
 #include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/traced-callback.h"
 
+#include <deque>
+#include <map>
+#include <vector>
+
 namespace ns3
 {
 
 class Address;
+class NetDevice;
+class QueueBase;
+class QueueDisc;
 class RandomVariableStream;
 class Socket;
 class BurstGenerator;
@@ -42,7 +54,7 @@ class BurstGenerator;
 /**
  * @ingroup bursty
  *
- * @brief Generate traffic to a single destination in bursty fashion.
+ * @brief Generate traffic to one or more destinations in bursty fashion.
  *
  * This traffic generator supports large packets to be sent into smaller
  * packet (fragment) bursts.
@@ -51,8 +63,10 @@ class BurstGenerator;
  * The burst size and period are controlled by a class extending the
  * BurstGenerator interface.
  *
- * This application assumes to operate on top of a UDP socket, sending
- * data to a BurstSink.
+ * This application usually operates on top of a UDP socket, sending
+ * data to a BurstSink. Over stream sockets, e.g., TCP, each fragment is
+ * preceded by a BurstStreamHeader with its size, so that the BurstSink can
+ * split the byte stream back into fragments.
  * These two classes coexist, one fragmenting a large packet into a burst
  * of smaller fragments, the other by re-assembling the fragments into
  * the full packet.
@@ -61,13 +75,94 @@ class BurstGenerator;
  * The last two segments of the burst might be shorter: the last one
  * because it represents the remainder of the burst size with respect to
  * the maximum frame size, the second to last because packets cannot be
- * smaller that the SeqTsSizeFragHeader size. If the last fragment is
+ * smaller that the fragment header. If the last fragment is
  * too short, the second to last fragment is shortened in order to
  * increase the size of the last fragment.
  * Also, if a BurstGenerator generates a burst of size less than the
- * SeqTsSizeFragHeader size, the burst is discarded and a new burst is
+ * fragment header, the burst is discarded and a new burst is
  * queried to the generator.
  *
+ * The HeaderFormat selects the fixed-size SeqTsSizeFragHeader, or the
+ * variable-length CompactFragHeader, which carries the metadata of the
+ * burst only on fragment 0 and on the parity fragments. Each compact fragment
+ * is sized upon its own header, so that the fragments add up to the burst size
+ * on the wire, except for bursts protected by FEC, whose fragments are sized
+ * upon the largest header of the burst to carry payloads of equal size. The
+ * BurstSink must use the same HeaderFormat.
+ *
+ * Bursts can be larger than 4 GB, and be fragmented into more than 32767
+ * fragments, switching to version 2 of SeqTsSizeFragHeader (see
+ * BurstGenerator::GenerateLargeBurst). As ns-3 packets are limited to 4 GB,
+ * such bursts are not materialized: the BurstTx trace carries an empty
+ * packet, and the burst size is found in the header.
+ *
+ * By default, all fragments of a burst are sent to the socket at the same
+ * time: they are all built, parity fragments included, with their headers
+ * serialized once, and then sent as a single batch, checking the TX space of
+ * each receiver once per batch. Optionally, fragments can be paced, spreading
+ * them evenly over the PacingWindow, or sending them at the PacingRate.
+ * Paced fragments are
+ * queued by the application and sent by a dedicated chain of events,
+ * independent of the burst period. If a new burst is generated while
+ * fragments of the previous one are still queued, its fragments are queued
+ * after them. All fragments of a burst carry the time stamp of the burst
+ * creation.
+ *
+ * Bursts can be protected by forward error correction, setting the
+ * FecScheme and the number of FecParityFragments: parity fragments,
+ * computed by a BurstFecCodec over the data fragments, are sent after the
+ * data fragments of each burst, allowing the BurstSink to recover lost
+ * fragments without retransmissions. Each parity fragment is as large as
+ * the largest data fragment of the burst. The XOR scheme uses at most as
+ * many parity fragments as data fragments.
+ *
+ * As a low-latency alternative to FEC, the application can retransmit the
+ * fragments listed by the NACKs of a BurstSink, received on the same
+ * socket. The fragments of the last RetransmissionBuffer bursts are kept, and
+ * the requested ones are retransmitted right away, bypassing the pacing
+ * queue, unless older than the RetransmissionDeadline.
+ *
+ * If a RateController is set, the periodic reception reports of the
+ * BurstSink are used to retune the TargetDataRate attribute of the
+ * BurstGenerator at runtime, e.g., of a VrBurstGenerator, adapting the
+ * bitrate to the delay and losses experienced by the flow.
+ *
+ * Under overload, stale frames would delay fresh ones. With a
+ * DeadlinePolicy, each burst must be sent within its deadline since its
+ * creation, the BurstDeadline or, if zero, the period to the next burst.
+ * New bursts are checked against the backlog in front of them: the pacing
+ * queue, the TX buffer of stream sockets, and the root queue disc and the
+ * transmission queues of the device towards each peer, e.g., the per-access
+ * category queues of Wi-Fi devices. The backlog drains at the rate the
+ * queues are measured to be served while busy or, until measured, at the
+ * data rate of the link, so that a burst fitting in a long queue is still
+ * dropped if the queue cannot drain in time. At least one of them must be
+ * available. Bursts are either dropped or truncated to the fragments which
+ * can make the deadline, while paced fragments past the deadline are
+ * dropped from the queue. A truncated burst is announced to the sinks as a
+ * smaller burst made of the fragments actually sent, so that they do not
+ * NACK the dropped ones. Dropped bursts, or their dropped fragments, are
+ * reported by the BurstDropped trace.
+ *
+ * Fragments can be prioritized by the importance class of their burst, as
+ * returned by BurstGenerator::GetBurstImportance, e.g., I-frames over
+ * P-frames. Each importance class can be mapped to a socket priority,
+ * carried by a SocketPriorityTag and used by Wi-Fi EDCA and by the
+ * traffic-control queue discs, or to an IPv4 TOS, carried by a
+ * SocketIpTosTag along with the matching priority. Classes not mapped are
+ * sent with the defaults of the socket.
+ *
+ * The same bursts can be fanned out to several receivers, e.g., the
+ * headsets sharing a VR scene: further destinations are added with
+ * AddRemote, or BurstyHelper::AddRemote, each with its own socket bound to
+ * an ephemeral port of the Local address, while a single BurstGenerator
+ * drives all of them. The fragments of a burst are created and their
+ * headers serialized once, and each receiver gets a copy-on-write copy
+ * sharing their payload. BurstTx, FragmentTx and FragmentRetx are traced
+ * for each receiver, with its own addresses, and NACKs are answered only to
+ * the receiver sending them. Alternatively, Remote can be a multicast group
+ * joined by the BurstSinks.
+ *
  */
 class BurstyApplication : public Application
 {
@@ -78,16 +173,49 @@ class BurstyApplication : public Application
      */
     static TypeId GetTypeId(void);
 
+    /**
+     * @brief Policy for the bursts which cannot make their deadline
+     */
+    enum DeadlinePolicy
+    {
+        NoDeadline = 0, //!< All bursts are sent, regardless of their deadline
+        DropBurst,      //!< Bursts which cannot make their deadline are dropped
+        TruncateBurst   //!< Only the fragments which can make the deadline are sent
+    };
+
     BurstyApplication();
 
     virtual ~BurstyApplication();
 
     /**
      * @brief Return a pointer to associated socket.
-     * @return pointer to associated socket
+     * @return pointer to the socket connected to Remote
      */
     Ptr<Socket> GetSocket(void) const;
 
+    /**
+     * @brief Add a destination to which the bursts are fanned out, in addition to Remote
+     * @param remote the address of the destination
+     *
+     * Must be called before the application starts.
+     */
+    void AddRemote(const Address& remote);
+
+    /**
+     * @brief Tag the fragments of the bursts of an importance class with a socket priority
+     * @param importance the importance class, as in BurstGenerator::GetBurstImportance
+     * @param priority the socket priority, e.g., 6 for the Wi-Fi AC_VO access category
+     */
+    void SetImportancePriority(uint8_t importance, uint8_t priority);
+
+    /**
+     * @brief Tag the fragments of the bursts of an importance class with an IPv4 TOS, and with
+     * the matching socket priority
+     * @param importance the importance class, as in BurstGenerator::GetBurstImportance
+     * @param tos the IPv4 TOS, e.g., 0xb8 for DSCP EF
+     */
+    void SetImportanceTos(uint8_t importance, uint8_t tos);
+
     /**
      * @brief Returns a pointer to the associated BurstGenerator
      * @return pointer to associated BurstGenerator
@@ -102,7 +230,7 @@ class BurstyApplication : public Application
 
     /**
      * @brief Return the total number of transmitted fragments.
-     * @return number of transmitted fragments
+     * @return number of transmitted fragments, summed over all receivers
      */
     uint64_t GetTotalTxFragments(void) const;
 
@@ -112,6 +240,27 @@ class BurstyApplication : public Application
      */
     uint64_t GetTotalTxBytes(void) const;
 
+    /**
+     * @brief Return the total number of retransmitted fragments.
+     * @return number of retransmitted fragments
+     */
+    uint64_t GetTotalRetxFragments(void) const;
+
+    /**
+     * @brief Return the total number of bursts dropped, entirely or in part, as they could
+     * not make their deadline.
+     * @return number of dropped bursts
+     */
+    uint64_t GetTotalDroppedBursts(void) const;
+
+    /**
+     * TracedCallback signature for a burst dropped as it cannot make its deadline
+     *
+     * @param header The header of the first fragment dropped
+     * @param droppedFrags The number of fragments of the burst dropped
+     */
+    typedef void (*DroppedBurstCallback)(const SeqTsSizeFragHeader& header, uint32_t droppedFrags);
+
   protected:
     virtual void DoDispose(void);
 
@@ -135,20 +284,300 @@ class BurstyApplication : public Application
     /**
      * @brief Send burst fragmented into multiple packets
      * @param burstSize the size of the burst in Bytes
+     * @param deadline the deadline of the burst since its creation, zero if none
      */
-    void SendFragmentedBurst(uint32_t burstSize);
+    void SendFragmentedBurst(uint64_t burstSize, Time deadline);
 
     /**
-     * @brief Send a single fragment
-     * @param fragment the fragment to send
-     * @param burstSize size of the entire burst in bytes
-     * @param totFrags the number of fragments composing the burst
-     * @param fragmentSeq the sequence number of the fragment
+     * @brief Get the number of fragments of a new burst which can make its deadline
+     *
+     * The fragments must fit in the free space of the queues in front of each receiver, and
+     * be transmitted within the deadline after the backlog already queued drains, at the
+     * measured drain rate of the queues or, until measured, at the link rate.
+     * @param txFrags the number of data and parity fragments of the burst
+     * @param deadline the deadline of the burst since its creation
+     * @return the number of leading fragments which can make the deadline
+     */
+    uint32_t GetDeadlineFragments(uint32_t txFrags, Time deadline);
+
+    /**
+     * @brief Create the payload of a data fragment
+     * @param burst the burst payload, empty if the burst is larger than 4 GB
+     * @param start the offset of the fragment payload within the burst [B]
+     * @param size the size of the fragment payload [B]
+     * @return the payload of the fragment, without header
+     */
+    Ptr<Packet> CreateFragmentPayload(Ptr<const Packet> burst,
+                                      uint64_t start,
+                                      uint32_t size) const;
+
+    /**
+     * @brief Get the number of parity fragments protecting a burst
+     * @param totFrags the number of data fragments of the burst
+     * @return the number of parity fragments, zero if FEC is disabled
+     */
+    uint32_t GetParityFragments(uint32_t totFrags) const;
+
+    /**
+     * @brief Get the size of a fragment header, in the configured HeaderFormat
+     * @param header the header of the fragment
+     * @return the serialized size of the header [B]
+     */
+    uint32_t GetHeaderSize(const SeqTsSizeFragHeader& header) const;
+
+    /**
+     * @brief Get the size of the largest fragment header of a burst
+     * @param burstSize the size of the burst [B], an upper bound to its payload
+     * @param totFrags the number of data fragments of the burst
+     * @param parityFrags the number of parity fragments of the burst
+     * @return the size of the largest fragment header of the burst [B]
+     */
+    uint32_t GetMaxHeaderSize(uint64_t burstSize, uint32_t totFrags, uint32_t parityFrags) const;
+
+    /**
+     * @brief Get the total size of the compact headers of the fragments of a burst without FEC
+     * @param burstSize the size of the burst [B]
+     * @param totFrags the number of data fragments of the burst
+     * @param firstHeaderSize set to the size of the header of fragment 0 [B]
+     * @return the total size of the headers of the data fragments [B]
+     *
+     * Fragment 0 carries the burst payload in its metadata, which in turn
+     * depends on the size of the headers. If the size of the payload varint
+     * cannot fit the burst size exactly, the larger header size is taken, and
+     * fragment 0 is one byte shorter on the wire.
+     */
+    uint64_t GetCompactHeadersSize(uint64_t burstSize,
+                                   uint32_t totFrags,
+                                   uint32_t& firstHeaderSize) const;
+
+    /**
+     * @brief Get the total size of the compact headers of the fragments following fragment 0
+     * @param frags the number of fragments, fragment 0 included
+     * @return the total size of the headers, without metadata, of fragments 1 to frags - 1 [B]
+     */
+    uint64_t GetCompactTrailingHeadersSize(uint32_t frags) const;
+
+    /**
+     * @brief Get the size of the compact header upon which a data fragment is sized
+     * @param header the header of the fragment
+     * @param firstHeaderSize the size of the header of fragment 0 [B]
+     * @return the size of the header of the fragment [B]
+     *
+     * Compact fragments are sized upon their own header, unless the burst is
+     * protected by FEC, which needs data fragments with payloads of equal size.
+     */
+    uint32_t GetDataHeaderSize(const SeqTsSizeFragHeader& header, uint32_t firstHeaderSize) const;
+
+    /**
+     * @brief A destination of the bursts, with its own socket
+     */
+    struct Receiver
+    {
+        Address m_peer{};       //!< Peer address
+        Ptr<Socket> m_socket{}; //!< Socket connected to the peer
+        Address m_sockName{};   //!< Local address of the socket, once bound
+        Address m_peerName{};   //!< Peer address of the socket, once connected
+        uint32_t m_txIdle{0};   //!< Available TX buffer of the idle socket [B]
+
+        /// Root queue disc of the device towards the peer
+        Ptr<QueueDisc> m_queueDisc{};
+        /// Transmission queues of the device towards the peer, e.g., one per Wi-Fi access category
+        std::vector<Ptr<QueueBase>> m_deviceQueues{};
+        /// Data rate of the link towards the peer, zero if unknown
+        DataRate m_linkRate{};
+        /// Rate at which the queues towards the peer were last measured to drain
+        DataRate m_drainRate{};
+        /// Whether the drain rate has been measured
+        bool m_hasDrainRate{false};
+        /// Whether the queues towards the peer held a backlog at the last sample
+        bool m_backlogged{false};
+        /// Bytes dequeued from the queues towards the peer at the last sample, modulo 4 GB [B]
+        uint32_t m_dequeuedBytes{0};
+        /// Time of the last sample of the queues towards the peer
+        Time m_sampleTime{};
+        /// Control packets read from the peer of a stream socket and not yet parsed
+        BurstStreamDeframer m_deframer{};
+    };
+
+    /**
+     * @brief Create, bind and connect the socket of a receiver
+     * @param receiver the receiver
+     */
+    void CreateSocket(Receiver& receiver);
+
+    /**
+     * @brief Find the output device towards a peer
+     * @param peer the peer address
+     * @return the output device, or nullptr if not found
+     */
+    Ptr<NetDevice> FindDevice(const Address& peer) const;
+
+    /**
+     * @brief Find the root queue disc, the transmission queues and the link rate of the device
+     * towards the peer of a receiver
+     * @param receiver the receiver
+     */
+    void FindQueues(Receiver& receiver) const;
+
+    /**
+     * @brief Get the bytes queued towards the peer of a receiver
+     * @param receiver the receiver
+     * @return the bytes in the TX buffer of stream sockets, the queue disc and the device [B]
+     */
+    uint64_t GetBacklogBytes(const Receiver& receiver) const;
+
+    /**
+     * @brief Get the bytes dequeued so far towards the peer of a receiver
+     * @param receiver the receiver
+     * @return the bytes dequeued by the device, or by the queue disc if the device queues
+     * are unknown, modulo 4 GB as the counters of the device queues [B]
+     */
+    uint32_t GetDequeuedBytes(const Receiver& receiver) const;
+
+    /**
+     * @brief Sample the queues towards the peer of a receiver, measuring their drain rate
+     * between two samples both finding a backlog, i.e., while the queues were busy
+     * @param receiver the receiver
+     * @param backlog the bytes currently queued towards the peer [B]
+     */
+    void UpdateDrainRate(Receiver& receiver, uint64_t backlog);
+
+    /**
+     * @brief Find the receiver a socket is connected to
+     * @param socket the socket
+     * @return the receiver, or nullptr if not found
+     */
+    Receiver* FindReceiver(Ptr<Socket> socket);
+
+    /**
+     * @brief Send a single fragment to all receivers
+     * @param fragment the fragment to send, without header
+     * @param header the header to add to the fragment
+     * @param retransmission whether the fragment is being retransmitted
      */
     void SendFragment(Ptr<Packet> fragment,
-                      uint64_t burstSize,
-                      uint16_t totFrags,
-                      uint16_t fragmentSeq);
+                      const SeqTsSizeFragHeader& header,
+                      bool retransmission = false);
+
+    /**
+     * @brief Add the header of a fragment, in the configured HeaderFormat, and its length
+     * prefix over stream sockets
+     * @param fragment the fragment, without header
+     * @param header the header to add to the fragment
+     */
+    void AddFragmentHeader(Ptr<Packet> fragment, const SeqTsSizeFragHeader& header) const;
+
+    /**
+     * @brief Send a single fragment to a receiver
+     * @param receiver the receiver
+     * @param fragment the fragment to send, with its header
+     * @param header the header of the fragment
+     * @param retransmission whether the fragment is being retransmitted
+     */
+    void SendFragmentTo(Receiver& receiver,
+                        Ptr<Packet> fragment,
+                        const SeqTsSizeFragHeader& header,
+                        bool retransmission);
+
+    /**
+     * @brief Send the fragments collected in the transmission batch, in order, and empty the
+     * batch
+     *
+     * The TX space of each receiver is checked once for the whole batch, and the fragments are
+     * then handed to its socket back to back, firing FragmentTx or FragmentRetx for each of them.
+     * ns-3 sockets have no vectored send: this is the single point where one would plug in.
+     * @param retransmission whether the fragments are being retransmitted
+     * @param receiver the receiver of the batch, or nullptr to send it to all receivers
+     */
+    void SendFragmentBatch(bool retransmission, Receiver* receiver = nullptr);
+
+    /**
+     * @brief Queue a fragment for paced transmission, or add it to the
+     * transmission batch of the burst if pacing is disabled
+     * @param fragment the fragment to send, without header
+     * @param header the header to add to the fragment
+     * @param gap the time to wait after sending this fragment before sending
+     * the next queued one
+     * @param expiry the time after which the fragment is no longer sent, zero if none
+     */
+    void EnqueueFragment(Ptr<Packet> fragment,
+                         const SeqTsSizeFragHeader& header,
+                         Time gap,
+                         Time expiry);
+
+    /**
+     * @brief Keep a fragment in the retransmission buffer, if enabled
+     * @param fragment the fragment, without header
+     * @param header the header of the fragment
+     */
+    void StoreForRetransmission(Ptr<const Packet> fragment, const SeqTsSizeFragHeader& header);
+
+    /**
+     * @brief Add the QoS tags mapped to the importance class of the burst being sent
+     * @param fragment the fragment
+     */
+    void TagFragment(Ptr<Packet> fragment) const;
+
+    /**
+     * @brief Handle a control packet received from the BurstSink
+     * @param socket the receiving socket
+     */
+    void HandleRead(Ptr<Socket> socket);
+
+    /**
+     * @brief Dispatch a control packet received from the BurstSink
+     * @param packet the control packet, starting with its BurstControlHeader
+     * @param receiver the receiver which sent the packet
+     */
+    void HandleControl(Ptr<Packet> packet, Receiver& receiver);
+
+    /**
+     * @brief Retransmit the fragments listed by a NACK
+     * @param nack the NACK received
+     * @param receiver the receiver which sent the NACK
+     */
+    void HandleNack(const BurstNackHeader& nack, Receiver& receiver);
+
+    /**
+     * @brief Update the target data rate of the BurstGenerator from a reception report
+     * @param feedback the reception report received
+     */
+    void HandleFeedback(const BurstFeedbackHeader& feedback);
+
+    /**
+     * @brief Send the first queued fragment, if any, dropping the queued fragments past their
+     * expiry, and keep the pacing engine busy for its gap
+     */
+    void SendPendingFragment();
+
+    /**
+     * @brief Check whether fragments are paced
+     * @return true if either PacingWindow or PacingRate are set
+     */
+    bool IsPacingEnabled() const;
+
+    /**
+     * @brief Compute the time between the transmission of a paced fragment
+     * and the following one
+     * @param fragmentSize the size of the fragment including its header [B]
+     * @param totFrags the number of fragments composing the burst
+     * @return the pacing gap, zero if pacing is disabled
+     */
+    Time GetPacingGap(uint32_t fragmentSize, uint32_t totFrags) const;
+
+    /**
+     * @brief Compute and send the parity fragments of a burst
+     * @param burst the burst payload
+     * @param header the header of the burst, with the number of parity fragments set
+     * @param shardSize the size of the largest data fragment payload [B]
+     * @param txFrags the number of data and parity fragments of the burst to send
+     * @param expiry the time after which the fragments are no longer sent, zero if none
+     */
+    void SendParityFragments(Ptr<const Packet> burst,
+                             SeqTsSizeFragHeader header,
+                             uint32_t shardSize,
+                             uint32_t txFrags,
+                             Time expiry);
 
     /**
      * @brief Handle a Connection Succeed event
@@ -156,23 +585,99 @@ class BurstyApplication : public Application
      */
     void ConnectionSucceeded(Ptr<Socket> socket);
 
+    /**
+     * @brief Cache the local and peer addresses of the socket of a receiver, reported by the
+     * traces
+     * @param receiver the receiver
+     */
+    void CacheSocketAddresses(Receiver& receiver);
+
     /**
      * @brief Handle a Connection Failed event
      * @param socket the not connected socket
      */
     void ConnectionFailed(Ptr<Socket> socket);
 
-    Ptr<Socket> m_socket;                 //!< Associated socket
-    Address m_peer;                       //!< Peer address
-    Address m_local;                      //!< Local address to bind to
-    bool m_connected;                     //!< True if connected
-    Ptr<BurstGenerator> m_burstGenerator; //!< Burst generator class
-    uint32_t m_fragSize;                  //!< Size of fragments including SeqTsSizeFragHeader
-    EventId m_nextBurstEvent;             //!< Event id for the next packet burst
-    TypeId m_socketTid;                   //!< Type of the socket used
-    uint64_t m_totTxBursts;               //!< Total bursts sent
-    uint64_t m_totTxFragments;            //!< Total fragments sent
-    uint64_t m_totTxBytes;                //!< Total bytes sent
+    Address m_peer;                         //!< Peer address
+    Address m_local;                        //!< Local address to bind to
+    std::vector<Address> m_extraRemotes;    //!< Further destinations, added by AddRemote
+    std::vector<Receiver> m_receivers;      //!< Destinations of the bursts, Remote first
+    bool m_connected;                       //!< True if connected
+    bool m_streamFraming;                   //!< Whether fragments are length-prefixed
+    Ptr<BurstGenerator> m_burstGenerator;   //!< Burst generator class
+    uint32_t m_fragSize;                    //!< Size of fragments including their header
+    EventId m_nextBurstEvent;               //!< Event id for the next packet burst
+    TypeId m_socketTid;                     //!< Type of the socket used
+    uint64_t m_totTxBursts;                 //!< Total bursts sent
+    uint64_t m_totTxFragments;              //!< Total fragments sent
+    uint64_t m_totTxBytes;                  //!< Total bytes sent
+    Time m_pacingWindow;                    //!< Time over which the fragments of a burst are paced
+    DataRate m_pacingRate;                  //!< Rate at which fragments are paced
+    EventId m_nextFragmentEvent;            //!< Event id for the next paced fragment
+    Time m_nextFragmentTime;                //!< Earliest time to send the next paced fragment
+    BurstFecCodec::Scheme m_fecScheme;      //!< FEC scheme protecting the bursts
+    uint16_t m_fecParity;                   //!< Number of parity fragments per burst
+    BurstFecCodec m_fecCodec;               //!< FEC encoder
+    std::vector<uint8_t> m_fecDataBuffer;   //!< Data shards of the burst being encoded
+    std::vector<uint8_t> m_fecParityBuffer; //!< Parity shards of the burst being encoded
+    uint32_t m_retxBufferSize;              //!< Number of bursts kept for retransmission
+    Time m_retxDeadline;                    //!< Maximum age of a retransmitted burst, if positive
+    uint64_t m_totRetxFragments;            //!< Total fragments retransmitted
+    DeadlinePolicy m_deadlinePolicy;        //!< Policy for bursts missing their deadline
+    Time m_burstDeadline;                   //!< Deadline of the bursts, if positive
+    uint64_t m_totDroppedBursts;            //!< Total bursts dropped upon their deadline
+
+    Ptr<BurstRateController> m_rateController;  //!< Controller of the target data rate, if any
+    SeqTsSizeFragHeader::Format m_headerFormat; //!< Serialization format of the fragment headers
+
+    /**
+     * @brief A fragment waiting for paced transmission
+     */
+    struct PendingFragment
+    {
+        Ptr<Packet> m_fragment;       //!< The fragment, without header
+        SeqTsSizeFragHeader m_header; //!< The header of the fragment
+        Time m_gap;                   //!< Time to wait before sending the next fragment
+        Time m_expiry;                //!< Time after which it is no longer sent, if positive
+    };
+
+    std::deque<PendingFragment> m_pendingFragments; //!< Fragments waiting for paced transmission
+
+    /**
+     * @brief A fragment of the transmission batch
+     */
+    struct BatchedFragment
+    {
+        Ptr<Packet> m_fragment;       //!< The fragment, with its header
+        SeqTsSizeFragHeader m_header; //!< The header of the fragment, for the traces
+    };
+
+    std::vector<BatchedFragment> m_txBatch; //!< Fragments sent together, if not paced
+
+    /**
+     * @brief A burst kept for retransmission
+     */
+    struct SentBurst
+    {
+        SeqTsSizeFragHeader m_header;         //!< The header of the burst
+        std::vector<Ptr<Packet>> m_fragments; //!< The fragments, without header
+    };
+
+    std::deque<SentBurst> m_retxBuffer; //!< The last bursts sent, oldest first
+
+    /**
+     * @brief The QoS tags of the fragments of an importance class
+     */
+    struct ImportanceTags
+    {
+        bool m_hasPriority{false}; //!< Whether fragments carry a SocketPriorityTag
+        uint8_t m_priority{0};     //!< The socket priority
+        bool m_hasTos{false};      //!< Whether fragments carry a SocketIpTosTag
+        uint8_t m_tos{0};          //!< The IPv4 TOS
+    };
+
+    std::map<uint8_t, ImportanceTags> m_importanceTags; //!< QoS tags of each importance class
+    ImportanceTags m_burstTags;                         //!< QoS tags of the burst being sent
 
     // Traced Callbacks
     /// Callback for transmitted burst
@@ -181,6 +686,11 @@ class BurstyApplication : public Application
     /// Callback for transmitted fragment
     TracedCallback<Ptr<const Packet>, const Address&, const Address&, const SeqTsSizeFragHeader&>
         m_txFragmentTrace;
+    /// Callback for retransmitted fragment
+    TracedCallback<Ptr<const Packet>, const Address&, const Address&, const SeqTsSizeFragHeader&>
+        m_retxFragmentTrace;
+    /// Callback for bursts dropped, entirely or in part, upon their deadline
+    TracedCallback<const SeqTsSizeFragHeader&, uint32_t> m_droppedBurstTrace;
 };
 
 } // namespace ns3
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ *
+ */
+
+#include "compact-frag-header.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CompactFragHeader");
+
+NS_OBJECT_ENSURE_REGISTERED(CompactFragHeader);
+
+/// Flag set if the header carries the metadata of the burst
+static const uint8_t METADATA_FLAG = 0x01;
+/// Flag set if the metadata include the number of parity fragments and the FEC scheme
+static const uint8_t FEC_FLAG = 0x02;
+
+CompactFragHeader::CompactFragHeader()
+    : SeqTsSizeFragHeader()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CompactFragHeader::CompactFragHeader(const SeqTsSizeFragHeader& header)
+    : SeqTsSizeFragHeader(header),
+      m_hasMetadata(header.GetFragSeq() == 0 || header.GetFragSeq() >= header.GetFrags())
+{
+    NS_LOG_FUNCTION(this << header);
+}
+
+TypeId
+CompactFragHeader::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::CompactFragHeader")
+                            .SetParent<SeqTsSizeFragHeader>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<CompactFragHeader>();
+    return tid;
+}
+
+TypeId
+CompactFragHeader::GetInstanceTypeId(void) const
+{
+    return GetTypeId();
+}
+
+bool
+CompactFragHeader::HasMetadata(void) const
+{
+    return m_hasMetadata;
+}
+
+void
+CompactFragHeader::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    if (m_hasMetadata)
+    {
+        SeqTsSizeFragHeader::Print(os);
+    }
+    else
+    {
+        os << "(fragSeq=" << GetFragSeq() << ", seq=" << GetSeq() << ", no metadata)";
+    }
+}
+
+uint32_t
+CompactFragHeader::GetVarintSize(uint64_t value)
+{
+    uint32_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+void
+CompactFragHeader::WriteVarint(Buffer::Iterator& i, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        i.WriteU8(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    i.WriteU8(uint8_t(value));
+}
+
+uint64_t
+CompactFragHeader::ReadVarint(Buffer::Iterator& i)
+{
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = i.ReadU8();
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+uint32_t
+CompactFragHeader::GetSerializedSize(void) const
+{
+    uint32_t size = 1 + GetVarintSize(GetSeq()) + GetVarintSize(GetFragSeq());
+    if (m_hasMetadata)
+    {
+        size += GetVarintSize(GetTs().GetTimeStep()) + GetVarintSize(GetSize()) +
+                GetVarintSize(GetFrags());
+        if (GetParity() > 0)
+        {
+            size += GetVarintSize(GetParity()) + 1;
+        }
+    }
+    return size;
+}
+
+void
+CompactFragHeader::Serialize(Buffer::Iterator start) const
+{
+    NS_LOG_FUNCTION(this << &start);
+    Buffer::Iterator i = start;
+
+    uint8_t flags = 0;
+    if (m_hasMetadata)
+    {
+        flags |= METADATA_FLAG;
+        if (GetParity() > 0)
+        {
+            flags |= FEC_FLAG;
+        }
+    }
+    i.WriteU8(flags);
+    WriteVarint(i, GetSeq());
+    WriteVarint(i, GetFragSeq());
+    if (m_hasMetadata)
+    {
+        NS_ASSERT_MSG(GetTs().IsPositive(), "Negative time stamps cannot be serialized");
+        WriteVarint(i, GetTs().GetTimeStep());
+        WriteVarint(i, GetSize());
+        WriteVarint(i, GetFrags());
+        if (GetParity() > 0)
+        {
+            WriteVarint(i, GetParity());
+            i.WriteU8(GetFecScheme());
+        }
+    }
+}
+
+uint32_t
+CompactFragHeader::Deserialize(Buffer::Iterator start)
+{
+    NS_LOG_FUNCTION(this << &start);
+    Buffer::Iterator i = start;
+
+    uint8_t flags = i.ReadU8();
+    m_hasMetadata = (flags & METADATA_FLAG) != 0;
+    uint32_t seq = ReadVarint(i);
+    SetFragSeq(ReadVarint(i));
+    if (!m_hasMetadata)
+    {
+        SetSeq(seq);
+        SetSize(0);
+        SetFrags(0);
+        SetParity(0);
+        SetFecScheme(0);
+        return i.GetDistanceFrom(start);
+    }
+
+    int64_t ts = ReadVarint(i);
+    uint64_t size = ReadVarint(i);
+    SetFrags(ReadVarint(i));
+    SetParity(0);
+    SetFecScheme(0);
+    if (flags & FEC_FLAG)
+    {
+        SetParity(ReadVarint(i));
+        SetFecScheme(i.ReadU8());
+    }
+
+    // the time stamp of SeqTsHeader can only be set by deserializing it: rebuild the
+    // SeqTsSizeHeader serialization, i.e., size, sequence number and time stamp
+    Buffer buffer;
+    buffer.AddAtStart(SeqTsSizeHeader::GetSerializedSize());
+    Buffer::Iterator full = buffer.Begin();
+    full.WriteHtonU64(size);
+    full.WriteHtonU32(seq);
+    full.WriteHtonU64(ts);
+    SeqTsSizeHeader::Deserialize(buffer.Begin());
+
+    return i.GetDistanceFrom(start);
+}
+
+} // namespace ns3
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ *
+ */
+
+#ifndef COMPACT_FRAG_HEADER_H
+#define COMPACT_FRAG_HEADER_H
+
+#include "seq-ts-size-frag-header.h"
+
+namespace ns3
+{
+
+/**
+ * @ingroup applications
+ * @brief Compact, variable-length serialization of a SeqTsSizeFragHeader
+ *
+ * All fragments carry a flags byte, and the burst and fragment sequence
+ * numbers as variable-length integers (LEB128 varints). The metadata of the
+ * burst, i.e., the time stamp, the burst size, the number of fragments, and
+ * the FEC parameters, are only carried by fragment 0 and by the parity
+ * fragments, which can recover the burst when fragment 0 is lost. The time
+ * stamp is carried as the varint number of time steps since the simulation
+ * start, rather than as a fixed 8-byte field.
+ *
+ * Fragments without metadata only carry a few bytes of header, instead of
+ * the 24 bytes of SeqTsSizeFragHeader: the receiver takes the metadata of the
+ * burst from its other fragments, and getters of the missing fields return
+ * zero until then.
+ */
+class CompactFragHeader : public SeqTsSizeFragHeader
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId(void);
+
+    /**
+     * @brief constructor
+     */
+    CompactFragHeader();
+
+    /**
+     * @brief Build the compact header of a fragment
+     * @param header the header of the fragment, carrying the metadata of its burst
+     *
+     * The metadata of the burst is serialized only if the fragment is the
+     * first data fragment or a parity fragment.
+     */
+    explicit CompactFragHeader(const SeqTsSizeFragHeader& header);
+
+    /**
+     * @brief Check whether the header carries the metadata of the burst
+     * @return true if the time stamp, size, number of fragments and FEC parameters are valid
+     */
+    bool HasMetadata(void) const;
+
+    // Inherited
+    virtual TypeId GetInstanceTypeId(void) const override;
+    virtual void Print(std::ostream& os) const override;
+    virtual uint32_t GetSerializedSize(void) const override;
+    virtual void Serialize(Buffer::Iterator start) const override;
+    virtual uint32_t Deserialize(Buffer::Iterator start) override;
+
+    /**
+     * @brief Get the size of a value serialized as a varint
+     * @param value the value
+     * @return the number of bytes of the varint
+     */
+    static uint32_t GetVarintSize(uint64_t value);
+
+  private:
+    /**
+     * @brief Serialize a value as a varint, 7 bits per byte, least significant first
+     * @param i the buffer iterator, moved past the varint
+     * @param value the value
+     */
+    static void WriteVarint(Buffer::Iterator& i, uint64_t value);
+
+    /**
+     * @brief Deserialize a varint
+     * @param i the buffer iterator, moved past the varint
+     * @return the value
+     */
+    static uint64_t ReadVarint(Buffer::Iterator& i);
+
+    bool m_hasMetadata{true}; //!< Whether the header carries the metadata of the burst
+};
+
+} // namespace ns3
+
+#endif /* COMPACT_FRAG_HEADER_H */
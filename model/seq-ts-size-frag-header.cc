@@ -10,6 +10,7 @@
 
 #include "seq-ts-size-frag-header.h"
 
+#include "ns3/abort.h"
 #include "ns3/log.h"
 
 namespace ns3
@@ -19,6 +20,21 @@ NS_LOG_COMPONENT_DEFINE("SeqTsSizeFragHeader");
 
 NS_OBJECT_ENSURE_REGISTERED(SeqTsSizeFragHeader);
 
+/// First two bytes of a header of version 2 or later, never a valid version 1 fragment sequence
+static const uint16_t VERSION_MARKER = 0xFFFF;
+/// Flag of the number of fragments of a version 1 header, set if the FEC fields follow
+static const uint16_t V1_FEC_FLAG = 0x8000;
+/// Flag of the number of fragments of a version 2 header, set if the FEC fields follow
+static const uint32_t V2_FEC_FLAG = 0x80000000;
+/// Size of the fragment fields of a version 1 header, without FEC fields
+static const uint32_t V1_FRAG_FIELDS_SIZE = 4;
+/// Size of the FEC fields of a version 1 header
+static const uint32_t V1_FEC_FIELDS_SIZE = 3;
+/// Size of the marker, version and fragment fields of a version 2 header, without FEC fields
+static const uint32_t V2_FRAG_FIELDS_SIZE = 11;
+/// Size of the FEC fields of a version 2 header
+static const uint32_t V2_FEC_FIELDS_SIZE = 5;
+
 SeqTsSizeFragHeader::SeqTsSizeFragHeader()
     : SeqTsSizeHeader()
 {
@@ -41,42 +57,90 @@ SeqTsSizeFragHeader::GetInstanceTypeId(void) const
     return GetTypeId();
 }
 
+uint8_t
+SeqTsSizeFragHeader::GetVersion(void) const
+{
+    // version 1 fragment sequence numbers are below the marker, as long as frags + parity fit
+    // in the 15 bits left by the FEC flag
+    if (uint64_t(m_frags) + m_parity < V1_FEC_FLAG && m_fragSeq < VERSION_MARKER)
+    {
+        return 1;
+    }
+    return 2;
+}
+
 void
-SeqTsSizeFragHeader::SetFragSeq(uint16_t fragSeq)
+SeqTsSizeFragHeader::SetFragSeq(uint32_t fragSeq)
 {
     m_fragSeq = fragSeq;
 }
 
-uint16_t
+uint32_t
 SeqTsSizeFragHeader::GetFragSeq(void) const
 {
     return m_fragSeq;
 }
 
 void
-SeqTsSizeFragHeader::SetFrags(uint16_t frags)
+SeqTsSizeFragHeader::SetFrags(uint32_t frags)
 {
     m_frags = frags;
 }
 
-uint16_t
+uint32_t
 SeqTsSizeFragHeader::GetFrags(void) const
 {
     return m_frags;
 }
 
+void
+SeqTsSizeFragHeader::SetParity(uint32_t parity)
+{
+    m_parity = parity;
+}
+
+uint32_t
+SeqTsSizeFragHeader::GetParity(void) const
+{
+    return m_parity;
+}
+
+void
+SeqTsSizeFragHeader::SetFecScheme(uint8_t fecScheme)
+{
+    m_fecScheme = fecScheme;
+}
+
+uint8_t
+SeqTsSizeFragHeader::GetFecScheme(void) const
+{
+    return m_fecScheme;
+}
+
+bool
+SeqTsSizeFragHeader::HasFecFields(void) const
+{
+    return m_parity > 0 || m_fecScheme != 0;
+}
+
 void
 SeqTsSizeFragHeader::Print(std::ostream& os) const
 {
     NS_LOG_FUNCTION(this << &os);
-    os << "(fragSeq=" << m_fragSeq << ", frags=" << m_frags << ") AND ";
+    os << "(fragSeq=" << m_fragSeq << ", frags=" << m_frags << ", parity=" << m_parity
+       << ", fecScheme=" << uint16_t(m_fecScheme) << ") AND ";
     SeqTsSizeHeader::Print(os);
 }
 
 uint32_t
 SeqTsSizeFragHeader::GetSerializedSize(void) const
 {
-    return SeqTsSizeHeader::GetSerializedSize() + 4;
+    uint32_t fragFieldsSize = GetVersion() == 1 ? V1_FRAG_FIELDS_SIZE : V2_FRAG_FIELDS_SIZE;
+    if (HasFecFields())
+    {
+        fragFieldsSize += GetVersion() == 1 ? V1_FEC_FIELDS_SIZE : V2_FEC_FIELDS_SIZE;
+    }
+    return SeqTsSizeHeader::GetSerializedSize() + fragFieldsSize;
 }
 
 void
@@ -84,8 +148,31 @@ SeqTsSizeFragHeader::Serialize(Buffer::Iterator start) const
 {
     NS_LOG_FUNCTION(this << &start);
     Buffer::Iterator i = start;
-    i.WriteHtonU16(m_fragSeq);
-    i.WriteHtonU16(m_frags);
+    // the FEC fields are only carried by the headers of bursts protected by FEC
+    bool fec = HasFecFields();
+    if (GetVersion() == 1)
+    {
+        i.WriteHtonU16(m_fragSeq);
+        i.WriteHtonU16(m_frags | (fec ? V1_FEC_FLAG : 0));
+        if (fec)
+        {
+            i.WriteHtonU16(m_parity);
+            i.WriteU8(m_fecScheme);
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(m_frags & V2_FEC_FLAG, "Too many fragments: " << m_frags);
+        i.WriteHtonU16(VERSION_MARKER);
+        i.WriteU8(2);
+        i.WriteHtonU32(m_fragSeq);
+        i.WriteHtonU32(m_frags | (fec ? V2_FEC_FLAG : 0));
+        if (fec)
+        {
+            i.WriteHtonU32(m_parity);
+            i.WriteU8(m_fecScheme);
+        }
+    }
     SeqTsSizeHeader::Serialize(i);
 }
 
@@ -94,10 +181,39 @@ SeqTsSizeFragHeader::Deserialize(Buffer::Iterator start)
 {
     NS_LOG_FUNCTION(this << &start);
     Buffer::Iterator i = start;
-    m_fragSeq = i.ReadNtohU16();
-    m_frags = i.ReadNtohU16();
+    uint32_t fragFieldsSize = V1_FRAG_FIELDS_SIZE;
+    m_parity = 0;
+    m_fecScheme = 0;
+    uint16_t first = i.ReadNtohU16();
+    if (first != VERSION_MARKER)
+    {
+        m_fragSeq = first;
+        uint16_t frags = i.ReadNtohU16();
+        m_frags = frags & ~V1_FEC_FLAG;
+        if (frags & V1_FEC_FLAG)
+        {
+            m_parity = i.ReadNtohU16();
+            m_fecScheme = i.ReadU8();
+            fragFieldsSize += V1_FEC_FIELDS_SIZE;
+        }
+    }
+    else
+    {
+        uint8_t version = i.ReadU8();
+        NS_ABORT_MSG_IF(version != 2, "Unsupported SeqTsSizeFragHeader version " << +version);
+        m_fragSeq = i.ReadNtohU32();
+        uint32_t frags = i.ReadNtohU32();
+        m_frags = frags & ~V2_FEC_FLAG;
+        fragFieldsSize = V2_FRAG_FIELDS_SIZE;
+        if (frags & V2_FEC_FLAG)
+        {
+            m_parity = i.ReadNtohU32();
+            m_fecScheme = i.ReadU8();
+            fragFieldsSize += V2_FEC_FIELDS_SIZE;
+        }
+    }
     SeqTsSizeHeader::Deserialize(i);
-    return GetSerializedSize();
+    return SeqTsSizeHeader::GetSerializedSize() + fragFieldsSize;
 }
 
 } // namespace ns3
@@ -24,11 +24,38 @@ namespace ns3
  * of fragments can be used to track large fragments packets over protocols not guaranteeing packet
  * ordering, e.g., BurstyApplication over UDP.
  *
+ * If the burst is protected by forward error correction, the header also
+ * carries the number of parity fragments sent after the data fragments, and
+ * the FEC scheme used to compute them (see BurstFecCodec), flagged by the
+ * most significant bit of the number of fragments. Parity fragments have
+ * fragment sequence numbers from frags to frags + parity - 1. Bursts without
+ * FEC do not carry these fields.
+ *
+ * The header is versioned. Version 1 carries 16-bit fragment sequence
+ * numbers and counts, and is used whenever frags + parity fits in 15 bits,
+ * so that BurstSinks built before version 2 can still receive most bursts.
+ * Version 2 starts with the 0xFFFF marker, never a valid version 1 fragment
+ * sequence number, followed by the version number and 32-bit fragment
+ * sequence numbers and counts. Deserialization tells the versions apart from
+ * the first two bytes, so that senders of both versions can share a sink.
+ * The burst size is 64-bit in both versions.
+ *
  * \sa ns3::SeqTsHeader
  */
 class SeqTsSizeFragHeader : public SeqTsSizeHeader
 {
   public:
+    /**
+     * @brief Serialization format of the fragment headers
+     *
+     * Both sender and receiver must be configured with the same format.
+     */
+    enum Format
+    {
+        Full = 0, //!< Fixed-size SeqTsSizeFragHeader on every fragment
+        Compact   //!< Variable-length CompactFragHeader, metadata on fragment 0 and parity only
+    };
+
     /**
      * @brief Get the type ID.
      * @return the object TypeId
@@ -40,29 +67,59 @@ class SeqTsSizeFragHeader : public SeqTsSizeHeader
      */
     SeqTsSizeFragHeader();
 
+    /**
+     * @brief Get the version of the serialized header
+     * @return 1 if the fragment fields fit in 15 bits, 2 otherwise
+     */
+    uint8_t GetVersion(void) const;
+
     /**
      * @brief Set the sequence number of the fragment
-     * @param size sequence number of the fragment
+     * @param fragSeq sequence number of the fragment
      */
-    void SetFragSeq(uint16_t fragSeq);
+    void SetFragSeq(uint32_t fragSeq);
 
     /**
      * @brief Get the sequence number of the fragment
      * @return the sequence number of the fragment
      */
-    uint16_t GetFragSeq(void) const;
+    uint32_t GetFragSeq(void) const;
 
     /**
      * @brief Set the total number fragments in the burst
      * @param frags the total number of fragments in the burst
      */
-    void SetFrags(uint16_t frags);
+    void SetFrags(uint32_t frags);
 
     /**
      * @brief Get the total number of fragments in the burst
      * @return the total number of fragments in the burst
      */
-    uint16_t GetFrags(void) const;
+    uint32_t GetFrags(void) const;
+
+    /**
+     * @brief Set the number of parity fragments of the burst
+     * @param parity the number of parity fragments of the burst
+     */
+    void SetParity(uint32_t parity);
+
+    /**
+     * @brief Get the number of parity fragments of the burst
+     * @return the number of parity fragments of the burst
+     */
+    uint32_t GetParity(void) const;
+
+    /**
+     * @brief Set the FEC scheme used for the parity fragments
+     * @param fecScheme the FEC scheme, as in BurstFecCodec::Scheme
+     */
+    void SetFecScheme(uint8_t fecScheme);
+
+    /**
+     * @brief Get the FEC scheme used for the parity fragments
+     * @return the FEC scheme, as in BurstFecCodec::Scheme
+     */
+    uint8_t GetFecScheme(void) const;
 
     // Inherited
     virtual TypeId GetInstanceTypeId(void) const override;
@@ -72,8 +129,16 @@ class SeqTsSizeFragHeader : public SeqTsSizeHeader
     virtual uint32_t Deserialize(Buffer::Iterator start) override;
 
   private:
-    uint16_t m_fragSeq{0}; //!< The sequence number of the fragment
-    uint16_t m_frags{0};   //!< The total number of fragments in the burst
+    /**
+     * @brief Check whether the FEC fields are serialized
+     * @return true if the burst is protected by FEC
+     */
+    bool HasFecFields(void) const;
+
+    uint32_t m_fragSeq{0};  //!< The sequence number of the fragment
+    uint32_t m_frags{0};    //!< The total number of fragments in the burst
+    uint32_t m_parity{0};   //!< The number of parity fragments of the burst
+    uint8_t m_fecScheme{0}; //!< The FEC scheme used for the parity fragments
 };
 
 } // namespace ns3
@@ -15,6 +15,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/string.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -39,6 +41,12 @@ SimpleBurstGenerator::GetTypeId(void)
                           "A RandomVariableStream used to pick the size of the burst [B].",
                           StringValue("ns3::ConstantRandomVariable[Constant=1e6]"),
                           MakePointerAccessor(&SimpleBurstGenerator::m_burstSizeRv),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("ImportanceRv",
+                          "A RandomVariableStream used to pick the importance class of the burst, "
+                          "from 0 to 255. If not set, all bursts have importance class 0.",
+                          PointerValue(),
+                          MakePointerAccessor(&SimpleBurstGenerator::m_importanceRv),
                           MakePointerChecker<RandomVariableStream>());
     return tid;
 }
@@ -59,7 +67,12 @@ SimpleBurstGenerator::AssignStreams(int64_t stream)
     NS_LOG_FUNCTION(this << stream);
     m_periodRv->SetStream(stream);
     m_burstSizeRv->SetStream(stream + 1);
-    return 2;
+    if (!m_importanceRv)
+    {
+        return 2;
+    }
+    m_importanceRv->SetStream(stream + 2);
+    return 3;
 }
 
 void
@@ -69,6 +82,7 @@ SimpleBurstGenerator::DoDispose(void)
 
     m_periodRv = 0;
     m_burstSizeRv = 0;
+    m_importanceRv = 0;
 
     // chain up
     BurstGenerator::DoDispose();
@@ -96,8 +110,21 @@ SimpleBurstGenerator::GenerateBurst()
     NS_ABORT_MSG_IF(!period.IsPositive(),
                     "Period must be non-negative, instead found period=" << period.As(Time::S));
 
-    NS_LOG_DEBUG("Burst size: " << burstSize << " B, period: " << period.As(Time::S));
+    // sample importance class of current burst
+    if (m_importanceRv)
+    {
+        m_importance = std::min<uint32_t>(m_importanceRv->GetInteger(), 255);
+    }
+
+    NS_LOG_DEBUG("Burst size: " << burstSize << " B, period: " << period.As(Time::S)
+                                << ", importance: " << +m_importance);
     return std::make_pair(burstSize, period);
 }
 
+uint8_t
+SimpleBurstGenerator::GetBurstImportance(void) const
+{
+    return m_importance;
+}
+
 } // Namespace ns3
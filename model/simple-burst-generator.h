@@ -24,7 +24,8 @@ class RandomVariableStream;
  *
  * This burst generator implements the BurstGenerator interface.
  * While being simple, it allows the user to customize the distributions
- * of the burst size and period with independent RandomVariableStreams.
+ * of the burst size, period and importance class with independent
+ * RandomVariableStreams.
  *
  */
 class SimpleBurstGenerator : public BurstGenerator
@@ -38,6 +39,7 @@ class SimpleBurstGenerator : public BurstGenerator
 
     // inherited from BurstGenerator
     virtual std::pair<uint32_t, Time> GenerateBurst(void) override;
+    virtual uint8_t GetBurstImportance(void) const override;
     /**
      * @brief This generator has not limits
      * @return always true
@@ -48,17 +50,21 @@ class SimpleBurstGenerator : public BurstGenerator
      * @brief Assign a fixed random variable stream number to the random variables
      * used by this model.
      *
+     * A stream is assigned to ImportanceRv only if it is set.
+     *
      * @param stream first stream index to use
      * @return the number of stream indices assigned by this model
      */
-    int64_t AssignStreams(int64_t stream);
+    virtual int64_t AssignStreams(int64_t stream) override;
 
   protected:
     virtual void DoDispose(void) override;
 
   private:
-    Ptr<RandomVariableStream> m_periodRv{0};    //!< rng for period duration [s]
-    Ptr<RandomVariableStream> m_burstSizeRv{0}; //!< rng for burst size [B]
+    Ptr<RandomVariableStream> m_periodRv{0};     //!< rng for period duration [s]
+    Ptr<RandomVariableStream> m_burstSizeRv{0};  //!< rng for burst size [B]
+    Ptr<RandomVariableStream> m_importanceRv{0}; //!< rng for burst importance class
+    uint8_t m_importance{0};                     //!< importance class of the last burst
 };
 
 } // namespace ns3
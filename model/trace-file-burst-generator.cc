@@ -10,12 +10,16 @@
 
 #include "trace-file-burst-generator.h"
 
-#include "ns3/csv-reader.h"
 #include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
 
 namespace ns3
 {
@@ -44,7 +48,38 @@ TraceFileBurstGenerator::GetTypeId(void)
                 DoubleValue(0.0),
                 MakeDoubleAccessor(&TraceFileBurstGenerator::GetStartTime,
                                    &TraceFileBurstGenerator::SetStartTime),
-                MakeDoubleChecker<double>(0.0));
+                MakeDoubleChecker<double>(0.0))
+            .AddAttribute("ChunkSize",
+                          "If strictly positive, the trace is streamed in chunks of this many "
+                          "bursts instead of being loaded at once. Must be set before the "
+                          "first burst is generated.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TraceFileBurstGenerator::m_chunkSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PrefetchThreshold",
+                          "If streaming the trace, the fraction of the current chunk to "
+                          "consume before reading the next one in the background.",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&TraceFileBurstGenerator::m_prefetchThreshold),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("TraceMode",
+                          "How the generator proceeds at the end of the trace: stop (Once), "
+                          "restart from the beginning (Loop), or stitch blocks starting at "
+                          "random times of the trace (BlockBootstrap).",
+                          EnumValue(TraceMode::Once),
+                          MakeEnumAccessor<TraceMode>(&TraceFileBurstGenerator::m_traceMode),
+                          MakeEnumChecker(TraceMode::Once,
+                                          "Once",
+                                          TraceMode::Loop,
+                                          "Loop",
+                                          TraceMode::BlockBootstrap,
+                                          "BlockBootstrap"))
+            .AddAttribute("BootstrapBlockDuration",
+                          "The duration of the blocks of consecutive bursts stitched together "
+                          "when the TraceMode is BlockBootstrap.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&TraceFileBurstGenerator::m_blockDuration),
+                          MakeTimeChecker());
     return tid;
 }
 
@@ -63,7 +98,8 @@ TraceFileBurstGenerator::DoDispose(void)
 {
     NS_LOG_FUNCTION(this);
 
-    ClearBurstQueue();
+    ReleaseTrace();
+    m_blockRv = nullptr;
 
     // chain up
     BurstGenerator::DoDispose();
@@ -76,7 +112,16 @@ TraceFileBurstGenerator::SetStartTime(double startTime)
     if (startTime != m_startTime)
     {
         m_startTime = startTime;
-        m_isFinalized = false;
+        if (m_isFinalized && !m_reader)
+        {
+            // the trace is already imported: only the cursor is moved
+            Seek();
+        }
+        else
+        {
+            // streamed traces are read again from the start
+            m_isFinalized = false;
+        }
     }
 }
 
@@ -111,7 +156,11 @@ TraceFileBurstGenerator::GetTraceDuration(void)
         ImportTrace();
     }
 
-    return m_traceDuration;
+    if (m_reader)
+    {
+        return (m_reader->GetDuration() - m_streamStart).GetSeconds();
+    }
+    return (m_trace->GetDuration() - m_trace->GetBurstStart(m_firstBurst)).GetSeconds();
 }
 
 bool
@@ -123,80 +172,215 @@ TraceFileBurstGenerator::HasNextBurst(void)
         ImportTrace();
     }
 
-    return !m_burstQueue.empty();
+    if (m_traceMode != TraceMode::Once)
+    {
+        // the trace is never exhausted
+        return true;
+    }
+    if (m_reader)
+    {
+        return m_reader->HasNext();
+    }
+    return m_cursor < m_trace->GetNBursts();
+}
+
+int64_t
+TraceFileBurstGenerator::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    if (m_traceMode != TraceMode::BlockBootstrap)
+    {
+        // no random numbers are drawn
+        return 0;
+    }
+    if (!m_blockRv)
+    {
+        m_blockRv = CreateObject<UniformRandomVariable>();
+    }
+    m_blockRv->SetStream(stream);
+    return 1;
 }
 
 std::pair<uint32_t, Time>
 TraceFileBurstGenerator::GenerateBurst()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::pair<uint64_t, Time> burst = GenerateLargeBurst();
+    NS_ABORT_MSG_IF(burst.first > std::numeric_limits<uint32_t>::max(),
+                    "Burst of " << burst.first << " B exceeds 4 GB: use GenerateLargeBurst");
+    return burst;
+}
+
+std::pair<uint64_t, Time>
+TraceFileBurstGenerator::GenerateLargeBurst()
 {
     NS_LOG_FUNCTION(this);
     if (!m_isFinalized)
     {
         ImportTrace();
     }
+    WrapAround();
 
-    NS_ABORT_MSG_IF(m_burstQueue.empty(),
+    if (m_reader)
+    {
+        NS_ABORT_MSG_IF(!m_reader->HasNext(),
+                        "All bursts from the trace have already been generated, "
+                        "you should have checked if HasNextBurst");
+        BurstTraceReader::Burst burst = m_reader->Next();
+        m_importance = burst.m_importance;
+        NS_LOG_DEBUG("Generated std::pair(" << burst.m_size << ", " << burst.m_period
+                                            << ") from the stream");
+        return std::make_pair(burst.m_size, burst.m_period);
+    }
+
+    NS_ABORT_MSG_IF(m_cursor >= m_trace->GetNBursts(),
                     "All bursts from the trace have already been generated, "
                     "you should have checked if HasNextBurst");
 
-    std::pair<uint32_t, Time> burst = m_burstQueue.front();
-    m_burstQueue.pop();
+    std::pair<uint64_t, Time> burst =
+        std::make_pair(m_trace->GetBurstSize(m_cursor), m_trace->GetPeriod(m_cursor));
+    m_importance = m_trace->GetImportance(m_cursor);
+    m_cursor++;
     NS_LOG_DEBUG("Generated std::pair(" << burst.first << ", " << burst.second << "); "
-                                        << m_burstQueue.size()
+                                        << m_trace->GetNBursts() - m_cursor
                                         << " more bursts excluding the current one");
     return burst;
 }
 
+uint8_t
+TraceFileBurstGenerator::GetBurstImportance(void) const
+{
+    return m_importance;
+}
+
 void
-TraceFileBurstGenerator::ClearBurstQueue(void)
+TraceFileBurstGenerator::ReleaseTrace(void)
 {
     NS_LOG_FUNCTION(this);
-    std::queue<std::pair<uint32_t, Time>> empty;
-    std::swap(m_burstQueue, empty);
+    if (m_trace)
+    {
+        m_trace = nullptr;
+        BurstTraceStore::Purge();
+    }
+    m_reader.reset();
+    m_cursor = 0;
+    m_firstBurst = 0;
 }
 
 void
-TraceFileBurstGenerator::ImportTrace(void)
+TraceFileBurstGenerator::Seek(void)
 {
     NS_LOG_FUNCTION(this);
 
-    // extract trace from file
-    CsvReader csv(m_traceFile);
+    // Ignore bursts before m_startTime
+    m_firstBurst = m_trace->FindBurst(Seconds(m_startTime));
+    m_cursor = m_firstBurst;
+    if (m_cursor < m_trace->GetNBursts())
+    {
+        // the first block of the bootstrap starts from StartTime
+        m_blockEnd = m_trace->GetBurstStart(m_cursor) + m_blockDuration;
+    }
+    NS_LOG_LOGIC("Starting from burst " << m_firstBurst << " of " << m_trace->GetNBursts());
+}
 
-    ClearBurstQueue();
-    m_traceDuration = 0;
-    double cumulativeStartTime = 0;
-    uint32_t burstSize;
-    double period;
-    while (csv.FetchNextRow())
+void
+TraceFileBurstGenerator::WrapAround(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    switch (m_traceMode)
     {
-        // Ignore blank lines
-        if (csv.IsBlankRow())
+    case TraceMode::Once:
+        break;
+    case TraceMode::Loop:
+        if (m_reader && !m_reader->HasNext())
         {
-            continue;
+            // streamed traces are read again from the beginning
+            m_reader =
+                std::make_unique<BurstTraceReader>(m_traceFile, m_chunkSize, m_prefetchThreshold);
+            NS_LOG_LOGIC("Looping the stream of file " << m_traceFile);
         }
+        else if (!m_reader && m_cursor >= m_trace->GetNBursts())
+        {
+            m_cursor = 0;
+            NS_LOG_LOGIC("Looping trace " << m_traceFile);
+        }
+        break;
+    case TraceMode::BlockBootstrap:
+        if (m_cursor >= m_trace->GetNBursts() || m_trace->GetBurstStart(m_cursor) >= m_blockEnd)
+        {
+            StartBlock();
+        }
+        break;
+    default:
+        NS_FATAL_ERROR("TraceMode " << m_traceMode << " not recognized");
+    }
+}
 
-        // Expecting burst size and period to next burst
-        bool ok = csv.GetValue(0, burstSize);
-        ok |= csv.GetValue(1, period);
-        NS_ABORT_MSG_IF(!ok,
-                        "Something went wrong on line " << csv.RowNumber() << " of file "
-                                                        << m_traceFile);
-        NS_ABORT_MSG_IF(period < 0,
-                        "Period to next burst should be non-negative, instead found: "
-                            << period << " on line " << csv.RowNumber());
-
-        // Ignore bursts before m_startTime
-        if (cumulativeStartTime >= m_startTime)
+void
+TraceFileBurstGenerator::StartBlock(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    // blocks start early enough to last BootstrapBlockDuration, unless longer than the trace
+    Time lastStart = std::max(m_trace->GetDuration() - m_blockDuration, Seconds(0));
+    if (!m_blockRv)
+    {
+        m_blockRv = CreateObject<UniformRandomVariable>();
+    }
+    Time blockStart = Seconds(m_blockRv->GetValue(0, lastStart.GetSeconds()));
+    m_cursor = std::min(m_trace->FindBurst(blockStart), m_trace->GetNBursts() - 1);
+    m_blockEnd = m_trace->GetBurstStart(m_cursor) + m_blockDuration;
+    NS_LOG_LOGIC("Starting a block from burst " << m_cursor << " at "
+                                                << m_trace->GetBurstStart(m_cursor).As(Time::S));
+}
+
+void
+TraceFileBurstGenerator::ImportTrace(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    NS_ABORT_MSG_IF(m_traceMode == TraceMode::BlockBootstrap && m_chunkSize > 0,
+                    "BlockBootstrap requires the whole trace: ChunkSize should be 0");
+    NS_ABORT_MSG_IF(m_traceMode == TraceMode::BlockBootstrap &&
+                        !m_blockDuration.IsStrictlyPositive(),
+                    "BootstrapBlockDuration should be strictly positive, instead found "
+                        << m_blockDuration.As(Time::S));
+
+    if (m_chunkSize > 0)
+    {
+        ReleaseTrace();
+        m_reader =
+            std::make_unique<BurstTraceReader>(m_traceFile, m_chunkSize, m_prefetchThreshold);
+
+        // Ignore bursts before m_startTime, reading through the trace
+        Time startTime = Seconds(m_startTime);
+        m_streamStart = Seconds(0);
+        while (m_streamStart < startTime && m_reader->HasNext())
         {
-            m_burstQueue.push(std::make_pair(burstSize, Seconds(period)));
-            m_traceDuration += period;
+            m_streamStart += m_reader->Next().m_period;
         }
-        cumulativeStartTime += period;
-    } // while FetchNextRow
+        NS_ABORT_MSG_IF(m_traceMode != TraceMode::Once &&
+                            !m_reader->GetDuration().IsStrictlyPositive(),
+                        "Can't loop trace " << m_traceFile << " lasting no time");
+        m_isFinalized = true;
+        NS_LOG_INFO("Streaming file " << m_traceFile << " from " << m_streamStart.As(Time::S));
+        return;
+    }
+
+    // the new trace is got first, not to release it if the same file is imported again
+    Ptr<const BurstTrace> trace = BurstTraceStore::Get(m_traceFile);
+    ReleaseTrace();
+    m_trace = trace;
+
+    NS_ABORT_MSG_IF(m_traceMode != TraceMode::Once && !m_trace->GetDuration().IsStrictlyPositive(),
+                    "Can't loop trace " << m_traceFile << " lasting no time");
+    Seek();
 
     m_isFinalized = true;
-    NS_LOG_INFO("Parsed " << m_burstQueue.size() << " bursts from file " << m_traceFile);
+    NS_LOG_INFO("Imported " << m_trace->GetNBursts() - m_cursor << " bursts from file "
+                            << m_traceFile);
 }
 
 } // Namespace ns3
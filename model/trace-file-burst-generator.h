@@ -11,8 +11,12 @@
 #define TRACE_FILE_BURST_GENERATOR_H
 
 #include "burst-generator.h"
+#include "burst-trace-reader.h"
+#include "burst-trace-store.h"
 
-#include <queue>
+#include "ns3/random-variable-stream.h"
+
+#include <memory>
 
 namespace ns3
 {
@@ -26,12 +30,37 @@ class Time;
  *
  * The generator reads a trace file and generates bursts accordingly.
  * A trace file should be formatted following the guidelines given
- * by the documentation of ns3::CsvReader.
+ * by the documentation of ns3::CsvReader, or be a binary trace (see
+ * BurstTraceFileHeader), e.g., converted by the burst-trace-converter
+ * example, which is memory-mapped instead of parsed.
+ * Each row holds the burst size [B], the period to the next burst [s]
+ * and, optionally, the importance class of the burst (see
+ * BurstGenerator::GetBurstImportance), 0 if missing.
  *
  * If the same trace file is used by multiple users in the same network,
  * the generated bursts can be decoupled by assigning different
  * StartTimes to different users, if the trace is long enough with respect
  * to the simulation duration.
+ * The file is parsed only once, and the resulting BurstTrace is shared by
+ * all the generators reading it through the BurstTraceStore, each generator
+ * keeping its own cursor into the trace.
+ *
+ * For traces too long to be held in memory, a ChunkSize can be set: the
+ * trace is then streamed by a BurstTraceReader of the generator, holding
+ * two chunks of bursts at a time and prefetching the next chunk once
+ * PrefetchThreshold of the current one is consumed. Streamed traces are not
+ * shared, and StartTime is reached by reading through the trace.
+ *
+ * By default, the generator stops at the end of the trace. Simulations
+ * longer than the trace can set the TraceMode to Loop, restarting from the
+ * beginning of the trace, or to BlockBootstrap, stitching blocks of
+ * consecutive bursts lasting BootstrapBlockDuration, each starting from a
+ * uniformly random time of the trace, which preserves the correlation of
+ * the bursts within a block. Both modes only move the cursor of the
+ * generator through the shared trace, without copying it, and
+ * BlockBootstrap requires the whole trace, i.e., no ChunkSize. Only
+ * BlockBootstrap draws random numbers, and thus takes a random variable
+ * stream.
  *
  */
 class TraceFileBurstGenerator : public BurstGenerator
@@ -43,17 +72,46 @@ class TraceFileBurstGenerator : public BurstGenerator
     // inherited from Object
     static TypeId GetTypeId();
 
+    /**
+     * How the generator proceeds at the end of the trace
+     */
+    enum TraceMode
+    {
+        Once = 0,      //!< Stop at the end of the trace
+        Loop,          //!< Restart from the beginning of the trace
+        BlockBootstrap //!< Stitch blocks of the trace starting at random times
+    };
+
     // inherited from BurstGenerator
     virtual std::pair<uint32_t, Time> GenerateBurst(void) override;
+    virtual std::pair<uint64_t, Time> GenerateLargeBurst(void) override;
+    virtual uint8_t GetBurstImportance(void) const override;
     /**
      * @brief Returns true while more bursts are present in the trace
-     * @return false when the end of the trace is reached
+     * @return false when the end of the trace is reached, always true when
+     * looping or bootstrapping the trace
      */
     virtual bool HasNextBurst(void) override;
 
+    /**
+     * @brief Assign a fixed random variable stream number to the random variables
+     * used by this model.
+     *
+     * A stream is only assigned if the TraceMode is BlockBootstrap, which
+     * should thus be set beforehand.
+     *
+     * @param stream first stream index to use
+     * @return the number of stream indices assigned by this model
+     */
+    virtual int64_t AssignStreams(int64_t stream) override;
+
     /**
      * @brief Returns the duration of the imported trace starting from the StartTime attribute
-     * @return the duration of the trace
+     *
+     * The duration is found in constant time, and the trace is imported only
+     * if not already done, e.g., not upon changing the StartTime. Looped and
+     * bootstrapped traces still report the duration of a single pass.
+     * @return the duration of the trace [s]
      */
     double GetTraceDuration(void);
 
@@ -69,23 +127,53 @@ class TraceFileBurstGenerator : public BurstGenerator
     std::string GetTraceFile(void) const;
 
     /**
-     * Clears the burst queue
+     * Releases the trace, if no longer used by other generators
      */
-    void ClearBurstQueue(void);
+    void ReleaseTrace(void);
 
     /**
-     * Import the trace file into the burst queue
+     * Get the trace from the BurstTraceStore and move the cursor to the StartTime
      */
     void ImportTrace(void);
 
+    /**
+     * Move the cursor to the first burst after the StartTime, with a binary search
+     */
+    void Seek(void);
+
+    /**
+     * Move the cursor back into the trace once past its end, or past the
+     * current block, if looping or bootstrapping the trace
+     */
+    void WrapAround(void);
+
+    /**
+     * Move the cursor to the start of a new block at a random time of the trace
+     */
+    void StartBlock(void);
+
     std::string m_traceFile{""}; //!< The name of the trace file
     double m_startTime{
         0.0}; //!< The trace will only generate traced traffic after a start time offset
-    double m_traceDuration{-1.0}; //!< The duration of the trace file considering the start time
     bool m_isFinalized{
         false}; //!< The generator is finalized only once ImportTrace ends with no errors
-    std::queue<std::pair<uint32_t, Time>>
-        m_burstQueue; //!< The burst information read from the trace
+    Ptr<const BurstTrace> m_trace; //!< The trace, shared with the generators reading the same file
+    uint64_t m_firstBurst{0};      //!< The position in the trace of the first burst after StartTime
+    uint64_t m_cursor{0};          //!< The position in the trace of the next burst
+    uint8_t m_importance{0};       //!< The importance class of the last burst
+    uint32_t m_chunkSize{0};       //!< The bursts per chunk if streaming, 0 to load the whole trace
+    Time m_streamStart;            //!< The start time of the first streamed burst
+    TraceMode m_traceMode{Once};   //!< How the generator proceeds at the end of the trace
+    Time m_blockDuration;          //!< The duration of the blocks of the bootstrap
+    Time m_blockEnd;               //!< The end time of the current block in the trace
+
+    /// The fraction of a chunk consumed before prefetching the next one, if streaming
+    double m_prefetchThreshold{0.5};
+    /// The reader streaming the trace, if ChunkSize is positive
+    std::unique_ptr<BurstTraceReader> m_reader;
+    /// The random variable drawing the start time of the blocks of the bootstrap, created
+    /// on demand so that the other modes do not take a stream
+    Ptr<UniformRandomVariable> m_blockRv;
 };
 
 } // namespace ns3
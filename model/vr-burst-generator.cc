@@ -157,6 +157,7 @@ std::pair<uint32_t, Time>
 VrBurstGenerator::GenerateBurst()
 {
     NS_LOG_FUNCTION(this);
+    m_started = true;
 
     // sample current frame size
     uint32_t frameSize = m_frameSizeRv->GetInteger();
@@ -270,12 +271,16 @@ VrBurstGenerator::SetupModel()
     NS_LOG_DEBUG("Frame size: loc=" << fsAvg << ", scale=" << fsScale
                                     << " (dispersion=" << fsDispersion << ")");
 
-    m_frameSizeRv = CreateObjectWithAttributes<LogisticRandomVariable>("Location",
-                                                                       DoubleValue(fsAvg),
-                                                                       "Scale",
-                                                                       DoubleValue(fsScale),
-                                                                       "Bound",
-                                                                       DoubleValue(fsAvg));
+    // until the first burst, the random variables are recreated upon each change, keeping the
+    // stream indices of seeded runs; afterwards, e.g., when a BurstRateController updates the
+    // target data rate, they are retuned in place, preserving their streams and state
+    if (!m_started)
+    {
+        m_frameSizeRv = CreateObject<LogisticRandomVariable>();
+    }
+    m_frameSizeRv->SetAttribute("Location", DoubleValue(fsAvg));
+    m_frameSizeRv->SetAttribute("Scale", DoubleValue(fsScale));
+    m_frameSizeRv->SetAttribute("Bound", DoubleValue(fsAvg));
 
     // Model IFI stats
     double ifiDispersion;
@@ -295,12 +300,13 @@ VrBurstGenerator::SetupModel()
     NS_LOG_DEBUG("IFI: loc=" << ifiAvg << ", scale=" << ifiScale << " (dispersion=" << ifiDispersion
                              << ")");
 
-    m_periodRv = CreateObjectWithAttributes<LogisticRandomVariable>("Location",
-                                                                    DoubleValue(ifiAvg),
-                                                                    "Scale",
-                                                                    DoubleValue(ifiScale),
-                                                                    "Bound",
-                                                                    DoubleValue(ifiAvg));
+    if (!m_started)
+    {
+        m_periodRv = CreateObject<LogisticRandomVariable>();
+    }
+    m_periodRv->SetAttribute("Location", DoubleValue(ifiAvg));
+    m_periodRv->SetAttribute("Scale", DoubleValue(ifiScale));
+    m_periodRv->SetAttribute("Bound", DoubleValue(ifiAvg));
 }
 
 } // Namespace ns3
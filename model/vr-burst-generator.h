@@ -68,7 +68,7 @@ class VrBurstGenerator : public BurstGenerator
      * @param stream first stream index to use
      * @return the number of stream indices assigned by this model
      */
-    int64_t AssignStreams(int64_t stream);
+    virtual int64_t AssignStreams(int64_t stream) override;
 
     // Set/Get app parameters
     /**
@@ -119,6 +119,7 @@ class VrBurstGenerator : public BurstGenerator
     double m_frameRate{60};           //!< The frame rate of the VR application [FPS]
     DataRate m_targetDataRate{50};    //!< The target data rate of the VR application
     VrAppName m_appName{VirusPopper}; //!< The name of the VR application
+    bool m_started{false};            //!< True once the first burst is generated
 
     Ptr<LogisticRandomVariable> m_periodRv{0};    //!< RNG for period duration [s]
     Ptr<LogisticRandomVariable> m_frameSizeRv{0}; //!< RNG for frame size [B]